@@ -0,0 +1,7 @@
+CREATE TABLE IF NOT EXISTS `solo_3v3_leaver` (
+  `guid` INT UNSIGNED NOT NULL COMMENT 'character guid',
+  `score` FLOAT NOT NULL DEFAULT 0 COMMENT 'leave score, decayed to last_update',
+  `last_update` INT UNSIGNED NOT NULL DEFAULT 0,
+  `lockout_until` INT UNSIGNED NOT NULL DEFAULT 0,
+  PRIMARY KEY (`guid`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci COMMENT='Solo 3v3 leaver penalties';
@@ -0,0 +1,12 @@
+CREATE TABLE IF NOT EXISTS `solo_3v3_history` (
+  `id` BIGINT UNSIGNED NOT NULL AUTO_INCREMENT,
+  `guid` INT UNSIGNED NOT NULL COMMENT 'character guid',
+  `time` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'unix time the ratings were saved',
+  `instance_id` INT UNSIGNED NOT NULL DEFAULT 0,
+  `bracket` TINYINT UNSIGNED NOT NULL DEFAULT 0,
+  `role` TINYINT UNSIGNED NOT NULL DEFAULT 0 COMMENT '0 melee, 1 range, 2 healer',
+  `rating_change` SMALLINT NOT NULL DEFAULT 0,
+  `mmr` SMALLINT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'mmr after the match',
+  PRIMARY KEY (`id`),
+  KEY `idx_guid_time` (`guid`, `time`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci COMMENT='Solo 3v3 rated matches per character';
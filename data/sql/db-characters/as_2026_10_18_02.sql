@@ -0,0 +1,7 @@
+CREATE TABLE IF NOT EXISTS `solo_3v3_forecast` (
+  `hour` SMALLINT UNSIGNED NOT NULL COMMENT 'hour of the week, 0 = Thursday 00:00 UTC',
+  `bracket` TINYINT UNSIGNED NOT NULL,
+  `role` TINYINT UNSIGNED NOT NULL COMMENT '0 melee, 1 range, 2 healer',
+  `joins` FLOAT NOT NULL DEFAULT 0 COMMENT 'moving average of the queue joins in that hour',
+  PRIMARY KEY (`hour`, `bracket`, `role`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci COMMENT='Solo 3v3 queue joins per hour of the week';
@@ -0,0 +1,6 @@
+CREATE TABLE IF NOT EXISTS `solo_3v3_invite` (
+  `guid` INT UNSIGNED NOT NULL COMMENT 'character guid',
+  `invites` SMALLINT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'recent solo invites resolved',
+  `accepts` SMALLINT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'of which the character entered the arena',
+  PRIMARY KEY (`guid`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci COMMENT='Solo 3v3 invite acceptance';
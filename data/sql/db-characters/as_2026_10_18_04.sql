@@ -0,0 +1,7 @@
+CREATE TABLE IF NOT EXISTS `solo_3v3_role_reward` (
+  `guid` INT UNSIGNED NOT NULL COMMENT 'character guid',
+  `multiplier` FLOAT NOT NULL DEFAULT 1 COMMENT 'role reward multiplier when the last rated solo arena formed',
+  `time` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'unix time that arena formed',
+  PRIMARY KEY (`guid`),
+  KEY `idx_time` (`time`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci COMMENT='Solo 3v3 role reward of the last rated arena';
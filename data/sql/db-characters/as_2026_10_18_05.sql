@@ -0,0 +1,5 @@
+CREATE TABLE IF NOT EXISTS `solo_3v3_season` (
+  `season_id` TINYINT UNSIGNED NOT NULL,
+  `start_time` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'unix time the module first ran the season, 0 for the season running at install',
+  PRIMARY KEY (`season_id`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci COMMENT='Solo 3v3 season start times';
@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` = 'soloq trace';
+INSERT INTO `command` (`name`, `security`, `help`) VALUES
+('soloq trace', 2, 'Syntax: .soloq trace $bracketId [$count]\r\nShows the last $count (default 50) solo 3v3 matcher decisions of a bracket. Only available when the module is built with ACORE_DEBUG or SOLO_3V3_MATCH_TRACE.');
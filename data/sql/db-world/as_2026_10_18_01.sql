@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` = 'soloq dump';
+INSERT INTO `command` (`name`, `security`, `help`) VALUES
+('soloq dump', 3, 'Syntax: .soloq dump\r\nWrites the solo 3v3 queue, reserved entries, running solo arenas, temp team count and config as JSON into Solo.3v3.DumpDirectory.');
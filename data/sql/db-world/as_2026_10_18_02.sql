@@ -0,0 +1,8 @@
+DELETE FROM `command` WHERE `name` IN ('soloq tournament open', 'soloq tournament join', 'soloq tournament leave', 'soloq tournament start', 'soloq tournament stop', 'soloq tournament status');
+INSERT INTO `command` (`name`, `security`, `help`) VALUES
+('soloq tournament open', 2, 'Syntax: .soloq tournament open\r\nOpens the registration of a Swiss style solo 3v3 tournament.'),
+('soloq tournament join', 0, 'Syntax: .soloq tournament join\r\nRegisters you for the open solo 3v3 tournament.'),
+('soloq tournament leave', 0, 'Syntax: .soloq tournament leave\r\nRemoves your registration while the tournament has not started.'),
+('soloq tournament start', 2, 'Syntax: .soloq tournament start $rounds\r\nCloses the registration and plays $rounds rounds. Each round pairs players of equal score into arenas, left over players get a bye.'),
+('soloq tournament stop', 2, 'Syntax: .soloq tournament stop\r\nCancels the solo 3v3 tournament. Running arenas are finished but not counted.'),
+('soloq tournament status', 0, 'Syntax: .soloq tournament status\r\nShows the state of the solo 3v3 tournament and the top 10 standings.');
@@ -0,0 +1,42 @@
+DROP TABLE IF EXISTS `solo_3v3_talent_role`;
+CREATE TABLE `solo_3v3_talent_role` (
+  `talent_tab` INT UNSIGNED NOT NULL COMMENT 'TalentTab.dbc id',
+  `role` TINYINT UNSIGNED NOT NULL COMMENT '0 = melee, 1 = range, 2 = healer',
+  PRIMARY KEY (`talent_tab`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci COMMENT='Solo 3v3 role of each talent tree';
+
+INSERT INTO `solo_3v3_talent_role` (`talent_tab`, `role`) VALUES
+(383, 0),
+(163, 0),
+(161, 0),
+(182, 0),
+(398, 0),
+(164, 0),
+(181, 0),
+(263, 0),
+(281, 0),
+(399, 0),
+(183, 0),
+(381, 0),
+(400, 0),
+(81, 1),
+(261, 1),
+(283, 1),
+(302, 1),
+(361, 1),
+(41, 1),
+(303, 1),
+(363, 1),
+(61, 1),
+(203, 1),
+(301, 1),
+(362, 1),
+(201, 2),
+(202, 2),
+(382, 2),
+(262, 2),
+(282, 2);
+
+DELETE FROM `command` WHERE `name` = 'soloq reloadroles';
+INSERT INTO `command` (`name`, `security`, `help`) VALUES
+('soloq reloadroles', 3, 'Syntax: .soloq reloadroles\r\nReloads the talent tree roles of solo 3v3 from solo_3v3_talent_role. Cached player roles are dropped when a mapping changed.');
@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` = 'soloq latency';
+INSERT INTO `command` (`name`, `security`, `help`) VALUES
+('soloq latency', 2, 'Syntax: .soloq latency\r\nShows the time solo 3v3 arenas spent between their lifecycle stages since startup (queue wait, arena creation, invite, invite accept, preparation, match, rating save) and the time players took to accept the invite.');
@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` = 'soloq archive';
+INSERT INTO `command` (`name`, `security`, `help`) VALUES
+('soloq archive', 3, 'Syntax: .soloq archive\r\nWrites the solo 3v3 fights of the season (log_arena_fights, log_arena_memberstats) and the current solo standings into a columnar archive file in Solo.3v3.DumpDirectory.');
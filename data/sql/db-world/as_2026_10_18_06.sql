@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` = 'soloq memory';
+INSERT INTO `command` (`name`, `security`, `help`) VALUES
+('soloq memory', 2, 'Syntax: .soloq memory\r\nShows the estimated bytes and entries of every container of the solo 3v3 module and their high-water marks since startup.');
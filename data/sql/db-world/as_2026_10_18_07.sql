@@ -0,0 +1,4 @@
+DELETE FROM `command` WHERE `name` IN ('soloq profile dump', 'soloq profile reset');
+INSERT INTO `command` (`name`, `security`, `help`) VALUES
+('soloq profile dump', 3, 'Syntax: .soloq profile dump\r\nShows the solo 3v3 module profile (calls, inclusive and exclusive time per call path) and writes it as folded stacks into Solo.3v3.DumpDirectory. Needs Solo.3v3.Profiler.Enable.'),
+('soloq profile reset', 3, 'Syntax: .soloq profile reset\r\nClears the counters of the solo 3v3 module profile.');
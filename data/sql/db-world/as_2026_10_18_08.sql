@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` = 'soloq forecast';
+INSERT INTO `command` (`name`, `security`, `help`) VALUES
+('soloq forecast', 2, 'Syntax: .soloq forecast\r\nShows the solo queue joins expected per bracket and role in the next 15 minutes, from the averages per hour of the week.');
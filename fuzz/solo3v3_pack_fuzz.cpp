@@ -0,0 +1,358 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * libFuzzer target for the solo matcher core (src/solo3v3_pack.*).
+ *
+ * The input is read as a list of queue operations (join, duo join, leave, invite, disconnect,
+ * reconnect, talent change, match end) on a model of one bracket. After every operation the
+ * matcher runs like on a queue update, its selection goes through Solo3v3CheckSelection and is
+ * applied, then the model asserts that no player is in two matches and that every player that
+ * joined and did not leave is either still queued or in exactly one match.
+ *
+ * Not part of the module build, it only needs Define.h of the core:
+ *   clang++ -std=c++17 -g -O1 -fsanitize=fuzzer,address,undefined -I src -I <azerothcore>/src/common \
+ *       fuzz/solo3v3_pack_fuzz.cpp src/solo3v3_pack.cpp -o solo3v3_pack_fuzz
+ */
+
+#include "solo3v3_pack.h"
+#include <cstdio>
+#include <cstdlib>
+
+#define FUZZ_ASSERT(cond, what) \
+    do { if (!(cond)) { std::fprintf(stderr, "solo3v3_pack_fuzz: %s\n", what); std::abort(); } } while (0)
+
+namespace
+{
+    constexpr uint32 FUZZ_PLAYERS = 24;
+
+    enum FuzzOp : uint8
+    {
+        FUZZ_JOIN = 0,
+        FUZZ_JOIN_DUO,
+        FUZZ_LEAVE,
+        FUZZ_INVITE,            // invited to another instance (backfill), stays in the queue until accepted
+        FUZZ_ACCEPT,
+        FUZZ_DISCONNECT,
+        FUZZ_RECONNECT,
+        FUZZ_TALENT_CHANGE,
+        FUZZ_MATCH_END,
+        MAX_FUZZ_OPS
+    };
+
+    enum FuzzPlayerState : uint8
+    {
+        FUZZ_IDLE = 0,
+        FUZZ_QUEUED,
+        FUZZ_MATCHED
+    };
+
+    struct FuzzPlayer
+    {
+        uint8 Role = 0;
+        bool Online = true;
+        FuzzPlayerState State = FUZZ_IDLE;
+        uint32 Match = 0;
+    };
+
+    struct FuzzGroup
+    {
+        uint64 Key = 0;
+        uint8 Players[2] = { };
+        uint8 Size = 1;
+        uint32 MMR = 0;
+        uint32 JoinTime = 0;
+        uint8 ListSide = 0;
+        bool Invited = false;
+    };
+
+    class FuzzBracket
+    {
+    public:
+        explicit FuzzBracket(Solo3v3PackOptions const& options) : options(options)
+        {
+            matchSizes.push_back(0); // match ids start at 1
+        }
+
+        void Apply(uint8 op, uint8 arg)
+        {
+            now += arg * 250;
+            uint32 p = arg % FUZZ_PLAYERS;
+
+            switch (op % MAX_FUZZ_OPS)
+            {
+                case FUZZ_JOIN:
+                    Join(p, FUZZ_PLAYERS, arg);
+                    break;
+                case FUZZ_JOIN_DUO:
+                    Join(p, options.AllowDuos ? (p + 1 + arg / FUZZ_PLAYERS) % FUZZ_PLAYERS : FUZZ_PLAYERS, arg);
+                    break;
+                case FUZZ_LEAVE:
+                    if (FuzzGroup* group = FindGroup(p))
+                        RemoveGroup(group, FUZZ_IDLE, 0);
+                    break;
+                case FUZZ_INVITE:
+                    if (FuzzGroup* group = FindGroup(p))
+                        group->Invited = true;
+                    break;
+                case FUZZ_ACCEPT:
+                    if (FuzzGroup* group = FindGroup(p))
+                        if (group->Invited)
+                            RemoveGroup(group, FUZZ_MATCHED, NewMatch(group->Size));
+                    break;
+                case FUZZ_DISCONNECT:
+                    players[p].Online = false;
+                    break;
+                case FUZZ_RECONNECT:
+                    players[p].Online = true;
+                    break;
+                case FUZZ_TALENT_CHANGE:
+                    players[p].Role = (arg / FUZZ_PLAYERS) % SOLO_PACK_ROLES;
+                    break;
+                case FUZZ_MATCH_END:
+                    if (players[p].State == FUZZ_MATCHED)
+                        EndMatch(players[p].Match);
+                    break;
+                default:
+                    break;
+            }
+
+            Match();
+            CheckInvariants();
+        }
+
+    private:
+        void Join(uint32 first, uint32 second, uint8 arg)
+        {
+            if (players[first].State != FUZZ_IDLE || !players[first].Online)
+                return;
+
+            FuzzGroup group;
+            group.Key = ++nextKey;
+            group.Players[0] = uint8(first);
+            group.MMR = 1000 + arg * 12;
+            group.JoinTime = now;
+            group.ListSide = arg & 1;
+
+            if (second < FUZZ_PLAYERS && second != first && players[second].State == FUZZ_IDLE && players[second].Online)
+            {
+                group.Players[1] = uint8(second);
+                group.Size = 2;
+            }
+
+            for (uint8 i = 0; i < group.Size; i++)
+                players[group.Players[i]].State = FUZZ_QUEUED;
+
+            queue.push_back(group);
+        }
+
+        FuzzGroup* FindGroup(uint32 player)
+        {
+            for (FuzzGroup& group : queue)
+                for (uint8 i = 0; i < group.Size; i++)
+                    if (group.Players[i] == player)
+                        return &group;
+
+            return nullptr;
+        }
+
+        void RemoveGroup(FuzzGroup* group, FuzzPlayerState state, uint32 match)
+        {
+            for (uint8 i = 0; i < group->Size; i++)
+            {
+                FuzzPlayer& player = players[group->Players[i]];
+                FUZZ_ASSERT(player.State == FUZZ_QUEUED, "player left a queue it was not in");
+                FUZZ_ASSERT(state != FUZZ_MATCHED || !player.Match, "player put into two matches");
+
+                player.State = state;
+                player.Match = match;
+            }
+
+            queue.erase(queue.begin() + (group - queue.data()));
+        }
+
+        uint32 NewMatch(uint32 size)
+        {
+            matchSizes.push_back(size);
+            return uint32(matchSizes.size() - 1);
+        }
+
+        void EndMatch(uint32 match)
+        {
+            for (FuzzPlayer& player : players)
+            {
+                if (player.State == FUZZ_MATCHED && player.Match == match)
+                {
+                    player.State = FUZZ_IDLE;
+                    player.Match = 0;
+                }
+            }
+
+            matchSizes[match] = 0;
+        }
+
+        // One queue update: same filtering as Solo3v3::CollectSolo3v3PackGroups, then the matcher
+        void Match()
+        {
+            packGroups.clear();
+            packQueued.clear();
+
+            for (uint8 side = 0; side < SOLO_PACK_SIDES; side++)
+            {
+                for (uint32 i = 0; i < queue.size(); i++)
+                {
+                    FuzzGroup const& queued = queue[i];
+                    if (queued.ListSide != side || queued.Invited)
+                        continue;
+
+                    Solo3v3PackGroup group;
+                    group.MMR = queued.MMR;
+                    group.Waited = now - queued.JoinTime;
+                    group.Size = queued.Size;
+                    bool online = true;
+
+                    for (uint8 p = 0; p < queued.Size; p++)
+                    {
+                        online = online && players[queued.Players[p]].Online;
+                        group.Roles[p] = options.FilterTalents ? players[queued.Players[p]].Role : 0;
+                    }
+
+                    if (!online)
+                        continue;
+
+                    group.Index = uint32(packQueued.size());
+                    packGroups.push_back(group);
+                    packQueued.push_back(queued.Key);
+                }
+            }
+
+            Solo3v3SortOldestFirst(packGroups);
+
+            bool matched = Solo3v3FindMatch(packGroups, options, [](Solo3v3PackGroup const& anchor)
+            {
+                return 100 + anchor.Waited / 100;
+            });
+
+            // a failed attempt keeps its decisions for the trace, only a match is applied
+            if (!matched)
+                return;
+
+            Solo3v3SelectedGroup selection[SOLO_PACK_MATCH_SIZE];
+            uint32 count = 0;
+
+            for (uint32 i = 0; i < packGroups.size(); i++)
+            {
+                if (packGroups[i].Result != SOLO_PACK_SELECTED)
+                    continue;
+
+                FUZZ_ASSERT(count < SOLO_PACK_MATCH_SIZE, "more than six groups selected");
+
+                FuzzGroup* queued = FindByKey(packQueued[packGroups[i].Index]);
+                FUZZ_ASSERT(queued, "selected group is not queued");
+
+                // faction swap
+                queued->ListSide = packGroups[i].Side;
+
+                Solo3v3SelectedGroup& group = selection[count++];
+                group.Key = queued->Key;
+                group.Side = packGroups[i].Side;
+                group.ListSide = queued->ListSide;
+                group.Invited = queued->Invited;
+                group.Size = queued->Size;
+
+                for (uint8 p = 0; p < queued->Size; p++)
+                {
+                    FuzzPlayer const& player = players[queued->Players[p]];
+                    group.Players[p] = queued->Players[p];
+                    group.Roles[p] = player.Role;
+                    group.Queued[p] = player.State == FUZZ_QUEUED && player.Online;
+                }
+            }
+
+            Solo3v3SelectionCheck check = Solo3v3CheckSelection(selection, count, options.FilterTalents);
+            if (check.Error != SOLO_SELECTION_OK)
+            {
+                std::fprintf(stderr, "solo3v3_pack_fuzz: %s at group %u\n", Solo3v3SelectionErrorText(check.Error), check.Group);
+                std::abort();
+            }
+
+            uint32 match = NewMatch(SOLO_PACK_MATCH_SIZE);
+            for (uint32 i = 0; i < count; i++)
+                RemoveGroup(FindByKey(selection[i].Key), FUZZ_MATCHED, match);
+        }
+
+        FuzzGroup* FindByKey(uint64 key)
+        {
+            for (FuzzGroup& group : queue)
+                if (group.Key == key)
+                    return &group;
+
+            return nullptr;
+        }
+
+        // Every player is idle, queued in exactly one group or in exactly one running match
+        void CheckInvariants()
+        {
+            uint32 inQueue[FUZZ_PLAYERS] = { };
+            for (FuzzGroup const& group : queue)
+                for (uint8 i = 0; i < group.Size; i++)
+                    inQueue[group.Players[i]]++;
+
+            std::vector<uint32> inMatch(matchSizes.size(), 0);
+
+            for (uint32 p = 0; p < FUZZ_PLAYERS; p++)
+            {
+                FuzzPlayer const& player = players[p];
+                FUZZ_ASSERT(inQueue[p] == (player.State == FUZZ_QUEUED ? 1u : 0u), "queued state and queue disagree");
+                FUZZ_ASSERT((player.State == FUZZ_MATCHED) == (player.Match != 0), "matched state and match id disagree");
+
+                if (player.State == FUZZ_MATCHED)
+                    inMatch[player.Match]++;
+            }
+
+            for (uint32 match = 1; match < matchSizes.size(); match++)
+                FUZZ_ASSERT(inMatch[match] == matchSizes[match], "match lost or gained a player");
+        }
+
+        Solo3v3PackOptions options;
+        FuzzPlayer players[FUZZ_PLAYERS];
+        std::vector<FuzzGroup> queue;
+        std::vector<uint32> matchSizes;
+        std::vector<Solo3v3PackGroup> packGroups;
+        std::vector<uint64> packQueued;
+        uint32 now = 0;
+        uint64 nextKey = 0;
+    };
+}
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size)
+{
+    if (size < 2)
+        return 0;
+
+    Solo3v3PackOptions options;
+    options.FilterTalents = data[0] & 1;
+    options.AllowDuos = data[0] & 2;
+    options.UseWindow = data[0] & 4;
+    options.MaxAnchors = data[1] % 4;
+
+    FuzzBracket bracket(options);
+    for (size_t i = 2; i + 1 < size; i += 2)
+        bracket.Apply(data[i], data[i + 1]);
+
+    return 0;
+}
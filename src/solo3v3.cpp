@@ -16,13 +16,27 @@
  */
 
 #include "solo3v3.h"
+#include "solo3v3_db.h"
+#include "solo3v3_events.h"
+#include "solo3v3_invite.h"
+#include "solo3v3_leaver.h"
+#include "solo3v3_memory.h"
+#include "solo3v3_profile.h"
+#include "solo3v3_rating.h"
+#include "solo3v3_remote.h"
+#include "solo3v3_roles.h"
+#include "solo3v3_tournament.h"
+#include "solo3v3_trace.h"
 #include "ArenaTeamMgr.h"
 #include "BattlegroundMgr.h"
 #include "Config.h"
+#include "DatabaseEnv.h"
 #include "Log.h"
 #include "ScriptMgr.h"
 #include "Chat.h"
 #include "DisableMgr.h"
+#include "GameTime.h"
+#include "Timer.h"
 
 Solo3v3* Solo3v3::instance()
 {
@@ -30,88 +44,128 @@ Solo3v3* Solo3v3::instance()
     return &instance;
 }
 
-void Solo3v3::SaveSoloDB(ArenaTeam* team)
+void Solo3v3::LoadConfig()
 {
-    if (!team)
-        return;
+    config.Enable = sConfigMgr->GetOption<bool>("Solo.3v3.Enable", true);
+    config.FilterTalents = sConfigMgr->GetOption<bool>("Solo.3v3.FilterTalents", false);
+    config.ValidateMatches = sConfigMgr->GetOption<bool>("Solo.3v3.ValidateMatches", true);
+    config.AllowDuoQueue = sConfigMgr->GetOption<bool>("Solo.3v3.AllowDuoQueue", false);
+    config.CastDeserterOnAfk = sConfigMgr->GetOption<bool>("Solo.3v3.CastDeserterOnAfk", true);
+    config.StopGameIncomplete = sConfigMgr->GetOption<bool>("Solo.3v3.StopGameIncomplete", true);
+    config.BackfillEnable = sConfigMgr->GetOption<bool>("Solo.3v3.Backfill.Enable", false);
+    config.BackfillMaxMMRDifference = sConfigMgr->GetOption<uint32>("Solo.3v3.Backfill.MaxMMRDifference", 300);
+    config.BackfillMinTimeLeft = sConfigMgr->GetOption<uint32>("Solo.3v3.Backfill.MinTimeLeft", 15) * IN_MILLISECONDS;
+    config.RoleBonusEnable = sConfigMgr->GetOption<bool>("Solo.3v3.RoleBonus.Enable", false);
+    config.RoleBonusFactor = sConfigMgr->GetOption<float>("Solo.3v3.RoleBonus.Factor", 0.5f);
+    config.RoleBonusMax = std::max(1.0f, sConfigMgr->GetOption<float>("Solo.3v3.RoleBonus.Max", 1.5f));
+    config.RoleBonusInterval = std::max<uint32>(1, sConfigMgr->GetOption<uint32>("Solo.3v3.RoleBonus.Interval", 30)) * IN_MILLISECONDS;
+
+    config.ArenaPointsMulti = sConfigMgr->GetOption<float>("Solo.3v3.ArenaPointsMulti", 0.8f);
+
+    for (uint32 bracket = 0; bracket < MAX_BATTLEGROUND_BRACKETS; bracket++)
+        for (uint32 role = 0; role < MAX_TALENT_CAT; role++)
+            roleRewardMultipliers[bracket][role] = 1.0f;
+
+    roleRewardTimer = config.RoleBonusInterval; // recalculate on the next tick
+    config.Cost = sConfigMgr->GetOption<uint32>("Solo.3v3.Cost", 1);
+}
 
-    // Init some variables for speedup the programm
-    ArenaTeam* realTeams[3];
-    uint32 itrRealTeam = 0;
+void Solo3v3::SaveSoloDB(Battleground* bg, ObjectGuid guid, TeamId winner)
+{
+    SOLO_3V3_PROFILE_SCOPE("Solo3v3::SaveSoloDB");
 
-    for (; itrRealTeam < 3; itrRealTeam++)
-        realTeams[itrRealTeam] = nullptr;
+    Solo3v3ArenaInfo* info = GetArenaInfo(bg->GetInstanceID());
+    if (!info)
+        return;
 
-    itrRealTeam = 0;
-    uint32 oldRating = 0;
+    // A backfilled slot belongs to the replacement, the player it replaced never played
+    uint32 teamId = BG_TEAMS_COUNT;
+    uint8 slot = 0;
 
-    // First get the old average rating by looping through all members in temp team and add up the rating
-    for (auto const& itr : team->GetMembers())
+    for (uint32 i = 0; i < BG_TEAMS_COUNT && teamId == BG_TEAMS_COUNT; i++)
     {
-        ArenaTeam* plrArenaTeam = nullptr;
-
-        // Find real arena team for player
-        for (auto const& itrMgr : sArenaTeamMgr->GetArenaTeams())
+        for (uint8 s = 0; s < info->PlayerCount[i]; s++)
         {
-            if (itrMgr.first < 0xFFF00000 && itrMgr.second->GetCaptain() == itr.Guid && itrMgr.second->GetType() == ARENA_TEAM_SOLO_3v3)
+            if (info->Players[i][s] == guid)
             {
-                plrArenaTeam = itrMgr.second; // found!
+                teamId = i;
+                slot = s;
                 break;
             }
         }
+    }
 
-        if (!plrArenaTeam)
-            continue; // Not found? Maybe player has left the game and deleted it before the arena game ends.
+    if (teamId == BG_TEAMS_COUNT || info->RatingSaved[teamId][slot])
+        return;
 
-        ASSERT(itrRealTeam < 3);
-        realTeams[itrRealTeam++] = plrArenaTeam;
+    info->RatingSaved[teamId][slot] = true;
 
-        oldRating += plrArenaTeam->GetRating(); // add up all ratings from each player team
-    }
+    ArenaTeam* ownTeam = sArenaTeamMgr->GetArenaTeamByCaptain(guid, ARENA_TEAM_SOLO_3v3);
+    if (!ownTeam)
+        return; // Not found? Maybe player has left the game and deleted it before the arena game ends.
 
-    if (team->GetMembersSize() > 0)
-        oldRating /= team->GetMembersSize(); // Get average
+    // Apply the change the players were shown when the match popped
+    bool won = winner == TeamId(teamId);
+    int32 ratingChange = won ? info->ExpectedGain[teamId] : info->ExpectedLoss[teamId];
 
-    int32 ratingModifier = team->GetRating() - oldRating; // GetRating() contains the new rating and oldRating is the old average rating
+    ArenaTeamStats stats = ownTeam->GetStats();
+    uint32 oldRating = stats.Rating;
 
-    itrRealTeam = 0;
+    stats.Rating = uint16(std::max<int32>(0, int32(stats.Rating) + ratingChange));
+    stats.SeasonGames++;
+    stats.WeekGames++;
 
-    // Let's loop again through temp arena team and add the new rating
-    for (auto const& _itr : team->GetMembers())
+    if (won)
     {
-        ArenaTeam* plrArenaTeam = realTeams[itrRealTeam++];
+        stats.SeasonWins++;
+        stats.WeekWins++;
+    }
 
-        if (!plrArenaTeam)
-            continue;
+    ownTeam->SetArenaTeamStats(stats);
+
+    ArenaTeamMember* member = ownTeam->GetMember(guid);
+    if (member)
+    {
+        member->PersonalRating = stats.Rating;
+        member->SeasonGames = stats.SeasonGames;
+        member->SeasonWins = stats.SeasonWins;
+        member->WeekGames = stats.WeekGames;
+        member->WeekWins = stats.WeekWins;
+
+        // The core moved the MMR of the temp team member when the arena ended
+        ArenaTeam* tempTeam = sArenaTeamMgr->GetArenaTeamById(info->ArenaTeamIds[teamId]);
+        if (ArenaTeamMember const* tempMember = tempTeam ? tempTeam->GetMember(guid) : nullptr)
+        {
+            member->MatchMakerRating = tempMember->MatchMakerRating;
+            member->MaxMMR = std::max(member->MaxMMR, tempMember->MatchMakerRating);
+        }
+    }
 
-        ArenaTeamStats atStats = plrArenaTeam->GetStats();
+    ownTeam->NotifyStatsChanged();
+    ownTeam->SaveToDB();
 
-        if (int32(atStats.Rating) + ratingModifier < 0)
-            atStats.Rating = 0;
-        else
-            atStats.Rating += ratingModifier;
+    // Only the floor at 0 may cut a loss short of the preview
+    int32 applied = int32(ownTeam->GetRating()) - int32(oldRating);
+    if (applied != ratingChange && ownTeam->GetRating() != 0)
+        LOG_ERROR("module", "Solo3v3: {} got {:+} rating in arena instance {}, the preview promised {:+}", guid.ToString(), applied, info->InstanceId, ratingChange);
 
-        atStats.SeasonGames = _itr.SeasonGames;
-        atStats.SeasonWins = _itr.SeasonWins;
-        atStats.WeekGames = _itr.WeekGames;
-        atStats.WeekWins = _itr.WeekWins;
+    uint32 mmr = member ? member->MatchMakerRating : 0;
 
-        for (auto realMemberItr : plrArenaTeam->GetMembers())
-        {
-            if (realMemberItr.Guid != plrArenaTeam->GetCaptain())
-                continue;
+    CharacterDatabase.Execute(GetSolo3v3Statement(SOLO_INS_HISTORY), guid.GetCounter(), uint32(GameTime::GetGameTime().count()), info->InstanceId,
+        uint32(info->BracketId), uint32(info->Roles[teamId][slot]), applied, mmr);
 
-            realMemberItr.PersonalRating = _itr.PersonalRating;
-            realMemberItr.MatchMakerRating = _itr.MatchMakerRating;
-            realMemberItr.SeasonGames = _itr.SeasonGames;
-            realMemberItr.SeasonWins = _itr.SeasonWins;
-            realMemberItr.WeekGames = _itr.WeekGames;
-            realMemberItr.WeekWins = _itr.WeekWins;
-        }
+    sSoloRating->OnRatingChange(guid, mmr);
+    sSoloEvents->Log(SOLO_EVENT_RATING, guid.GetCounter(), info->BracketId, info->InstanceId, mmr, applied, teamId, info->Roles[teamId][slot]);
+    sSoloRemote->SendRating(guid, mmr);
+
+    // The end reward saves everyone right when the arena ends, before the battleground update notices the new status
+    if (bg->GetStatus() == STATUS_WAIT_LEAVE)
+    {
+        uint32 savedTime = getMSTime();
+        if (!info->StageTime[SOLO_STAGE_MATCH_END])
+            info->StageTime[SOLO_STAGE_MATCH_END] = savedTime;
 
-        plrArenaTeam->SetArenaTeamStats(atStats);
-        plrArenaTeam->NotifyStatsChanged();
-        plrArenaTeam->SaveToDB();
+        info->StageTime[SOLO_STAGE_RATINGS_SAVED] = savedTime;
     }
 }
 
@@ -140,9 +194,17 @@ uint32 Solo3v3::GetAverageMMR(ArenaTeam* team)
 
 void Solo3v3::CleanUp3v3SoloQ(Battleground* bg)
 {
-    // Cleanup temp arena teams for solo 3v3
-    if (bg->isArena() && bg->isRated() && bg->GetArenaType() == ARENA_TYPE_3v3_SOLO)
+    // Cleanup temp arena teams for solo 3v3. The core only does it for rated arenas, tournament ones
+    // may be unrated. Teams are looked up by id, whoever runs second finds nothing left to delete.
+    if (bg->isArena() && bg->GetArenaType() == ARENA_TYPE_3v3_SOLO)
     {
+        // Gone after this either way, whoever deletes them
+        if (Solo3v3ArenaInfo const* info = GetArenaInfo(bg->GetInstanceID()))
+        {
+            tempTeamCount -= BG_TEAMS_COUNT;
+            tempTeamBytes -= info->TempTeamBytes;
+        }
+
         ArenaTeam* tempAlliArenaTeam = sArenaTeamMgr->GetArenaTeamById(bg->GetArenaTeamIdForTeam(TEAM_ALLIANCE));
         ArenaTeam* tempHordeArenaTeam = sArenaTeamMgr->GetArenaTeamById(bg->GetArenaTeamIdForTeam(TEAM_HORDE));
 
@@ -189,7 +251,7 @@ void Solo3v3::CheckStartSolo3v3Arena(Battleground* bg)
 
             if (plr->GetInstanceId() != bg->GetInstanceID())
             {
-                if (sConfigMgr->GetOption<bool>("Solo.3v3.CastDeserterOnAfk", true))
+                if (config.CastDeserterOnAfk)
                     plr->CastSpell(plr, 26013, true); // Deserter
 
                 someoneNotInArena = true;
@@ -197,135 +259,839 @@ void Solo3v3::CheckStartSolo3v3Arena(Battleground* bg)
         }
     }
 
-    if (someoneNotInArena && sConfigMgr->GetOption<bool>("Solo.3v3.StopGameIncomplete", true))
+    if (someoneNotInArena && config.StopGameIncomplete)
     {
+        sSoloEvents->Log(SOLO_EVENT_ABORT, 0, bg->GetBracketId(), bg->GetInstanceID());
         bg->SetRated(false);
         bg->EndBattleground(TEAM_NEUTRAL);
     }
 }
 
+void Solo3v3::BackfillSolo3v3Arena(Battleground* bg)
+{
+    SOLO_3V3_PROFILE_SCOPE("Solo3v3::BackfillSolo3v3Arena");
+
+    if (!config.BackfillEnable || bg->GetArenaType() != ARENA_TYPE_3v3_SOLO)
+        return;
+
+    if (bg->GetStartDelayTime() < int32(config.BackfillMinTimeLeft))
+        return;
+
+    // Tournament pairings are fixed, a missing player gets no stand-in from the queue
+    if (sSoloTournament->IsTournamentArena(bg->GetInstanceID()))
+        return;
+
+    Solo3v3ArenaInfo* info = GetArenaInfo(bg->GetInstanceID());
+    if (!info)
+        return;
+
+    uint32 now = GameTime::GetGameTimeMS().count();
+    if (now < info->NextBackfillCheck)
+        return;
+
+    info->NextBackfillCheck = now + IN_MILLISECONDS;
+
+    BattlegroundQueue& queue = sBattlegroundMgr->GetBattlegroundQueue(bgQueueTypeId);
+    bool backfilled = false;
+
+    // rated solo groups sit in the premade lists, unrated ones in the normal lists
+    uint32 firstList = bg->isRated() ? BG_QUEUE_PREMADE_ALLIANCE : BG_QUEUE_NORMAL_ALLIANCE;
+
+    for (uint32 teamId = 0; teamId < BG_TEAMS_COUNT; teamId++)
+    {
+        for (uint8 slot = 0; slot < info->PlayerCount[teamId]; slot++)
+        {
+            ObjectGuid missingGuid = info->Players[teamId][slot];
+
+            // Still coming: in the arena already or the invite is pending
+            if (bg->GetPlayers().count(missingGuid))
+                continue;
+
+            Player* missing = ObjectAccessor::FindPlayer(missingGuid);
+            if (missing && missing->IsInvitedForBattlegroundInstance(bg->GetInstanceID()))
+                continue;
+
+            // Longest waiting solo player of the same role close to the MMR of the missing one
+            GroupQueueInfo* replacement = nullptr;
+            Player* replacementPlayer = nullptr;
+
+            for (uint32 queueList = firstList; queueList < firstList + BG_TEAMS_COUNT; queueList++)
+            {
+                for (auto const& ginfo : queue.m_QueuedGroups[info->BracketId][queueList])
+                {
+                    if (ginfo->IsInvitedToBGInstanceGUID || ginfo->ArenaType != ARENA_TYPE_3v3_SOLO || ginfo->Players.size() != 1)
+                        continue;
+
+                    if (replacement && replacement->JoinTime <= ginfo->JoinTime)
+                        continue;
+
+                    uint32 mmr = ginfo->ArenaMatchmakerRating;
+                    uint32 mmrDifference = mmr > info->PlayerMMR[teamId][slot] ? mmr - info->PlayerMMR[teamId][slot] : info->PlayerMMR[teamId][slot] - mmr;
+                    if (mmrDifference > config.BackfillMaxMMRDifference)
+                        continue;
+
+                    Player* plr = ObjectAccessor::FindPlayer(*ginfo->Players.begin());
+                    if (!plr || GetCachedTalentCatForSolo3v3(plr) != info->Roles[teamId][slot])
+                        continue;
+
+                    if (sSoloInvites->IsHeldBack(plr->GetGUID(), getMSTimeDiff(ginfo->JoinTime, getMSTime())))
+                        continue;
+
+                    // Locked out by a desertion or quarantined while waiting
+                    if (sSoloLeaver->GetLockoutRemaining(plr->GetGUID()) || IsSolo3v3Quarantined(plr->GetGUID(), getMSTime()))
+                        continue;
+
+                    replacement = ginfo;
+                    replacementPlayer = plr;
+                }
+            }
+
+            if (!replacement)
+                continue;
+
+            ArenaTeam* tempTeam = sArenaTeamMgr->GetArenaTeamById(info->ArenaTeamIds[teamId]);
+            if (!tempTeam)
+                continue;
+
+            // Take over the slot of the temp team, ratings come from the own solo team like in CreateTempArenaTeam
+            for (auto& member : tempTeam->GetMembers())
+            {
+                if (member.Guid != missingGuid)
+                    continue;
+
+                member.Guid = replacementPlayer->GetGUID();
+                member.Name = replacementPlayer->GetName();
+                member.Class = replacementPlayer->getClass();
+                member.WeekGames = 0;
+                member.WeekWins = 0;
+                member.SeasonGames = 0;
+                member.SeasonWins = 0;
+                member.PersonalRating = 0;
+                member.MatchMakerRating = uint16(replacement->ArenaMatchmakerRating);
+                member.MaxMMR = uint16(replacement->ArenaMatchmakerRating);
+
+                if (ArenaTeam* ownTeam = sArenaTeamMgr->GetArenaTeamById(replacementPlayer->GetArenaTeamId(ArenaTeam::GetSlotByType(ARENA_TEAM_SOLO_3v3))))
+                {
+                    if (ArenaTeamMember const* ownMember = ownTeam->GetMember(replacementPlayer->GetGUID()))
+                    {
+                        member.PersonalRating = ownMember->PersonalRating;
+                        member.MatchMakerRating = ownMember->MatchMakerRating;
+                        member.MaxMMR = ownMember->MaxMMR;
+                    }
+                }
+
+                break;
+            }
+
+            // Replaced before entering: the invite was declined or expired
+            if (!info->AcceptTime[teamId][slot])
+                sSoloInvites->OnDeclined(missingGuid);
+
+            info->Players[teamId][slot] = replacementPlayer->GetGUID();
+            info->PlayerMMR[teamId][slot] = replacement->ArenaMatchmakerRating;
+            info->AcceptTime[teamId][slot] = 0;
+            info->TeamMMR[teamId] = GetAverageMMR(tempTeam);
+            bg->SetArenaMatchmakerRating(TeamId(teamId), info->TeamMMR[teamId]);
+
+            MoveQueuedGroupToTeam(&queue, info->BracketId, replacement, TeamId(teamId));
+            replacement->ArenaTeamId = tempTeam->GetId();
+            queue.InviteGroupToBG(replacement, bg, replacement->teamId);
+            bg->SetArenaTeamIdForTeam(TeamId(teamId), tempTeam->GetId());
+
+            OnQueueLeave(replacementPlayer->GetGUID());
+            sSoloRemote->SendLeave(replacementPlayer->GetGUID(), info->BracketId);
+
+            LOG_DEBUG("module", "Solo3v3: {} replaces {} in arena instance {}", replacementPlayer->GetGUID().ToString(), missingGuid.ToString(), bg->GetInstanceID());
+            ChatHandler(replacementPlayer->GetSession()).SendSysMessage("You were picked to replace a missing player in a solo arena that is about to start.");
+            backfilled = true;
+        }
+    }
+
+    if (!backfilled)
+        return;
+
+    // The team MMRs moved, both teams now play for a different rating change
+    UpdateExpectedRatingChanges(*info);
+
+    if (!bg->isRated())
+        return;
+
+    for (uint32 teamId = 0; teamId < BG_TEAMS_COUNT; teamId++)
+        for (uint8 slot = 0; slot < info->PlayerCount[teamId]; slot++)
+            if (Player* plr = ObjectAccessor::FindPlayer(info->Players[teamId][slot]))
+                SendRatingPreview(*info, teamId, plr);
+}
+
 bool Solo3v3::CheckSolo3v3Arena(BattlegroundQueue* queue, BattlegroundBracketId bracket_id)
 {
-    bool soloTeam[BG_TEAMS_COUNT][MAX_TALENT_CAT]; // 2 teams and each team 3 players - set to true when slot is taken
+    SOLO_3V3_PROFILE_SCOPE("Solo3v3::CheckSolo3v3Arena");
 
-    for (int i = 0; i < BG_TEAMS_COUNT; i++)
-        for (int j = 0; j < MAX_TALENT_CAT; j++)
-            soloTeam[i][j] = false; // default false = slot not taken
+    SOLO_3V3_TRACE_PASS(bracket_id);
+    SOLO_3V3_TRACE(bracket_id, SOLO_TRACE_PASS_START, 0, 0, 0, uint32(queue->m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].size() + queue->m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].size()));
 
     queue->m_SelectionPools[TEAM_ALLIANCE].Init();
     queue->m_SelectionPools[TEAM_HORDE].Init();
 
-    uint32 MinPlayersPerTeam = 3;
+    CollectSolo3v3PackGroups(queue, bracket_id);
 
-    bool filterTalents = sConfigMgr->GetOption<bool>("Solo.3v3.FilterTalents", false);
+    // Duos go first, at most one fits into each team and solos fill the gaps around them.
+    // When the placed duos can not be completed, the solos are packed on their own.
+    // With MMR windows the match is built around the oldest group of both factions, when that fails the
+    // next oldest get a turn. The window of an anchor widens the longer it waits.
+    Solo3v3PackOptions options;
+    options.FilterTalents = config.FilterTalents;
+    options.AllowDuos = config.AllowDuoQueue;
+    options.UseWindow = sSoloRating->IsEnabled();
+    options.MaxAnchors = options.UseWindow ? sSoloRating->GetAnchors() : 1;
 
-    for (int teamId = 0; teamId < 2; teamId++) // BG_QUEUE_PREMADE_ALLIANCE and BG_QUEUE_PREMADE_HORDE
+    bool matched;
     {
-        for (BattlegroundQueue::GroupsQueueType::iterator itr = queue->m_QueuedGroups[bracket_id][teamId].begin(); itr != queue->m_QueuedGroups[bracket_id][teamId].end(); ++itr)
+        SOLO_3V3_PROFILE_SCOPE("Solo3v3::PackSolo3v3Teams");
+        matched = Solo3v3FindMatch(packGroups, options, [bracket_id](Solo3v3PackGroup const& anchor)
         {
-            if ((*itr)->IsInvitedToBGInstanceGUID) // Skip when invited
+            return sSoloRating->GetMatchWindow(bracket_id, anchor.MMR, anchor.Waited);
+        });
+    }
+
+    // Decisions of the last attempt, the one that matched or the last that failed
+    uint32 selectedPlayers = 0;
+    for (uint32 i = 0; i < packGroups.size(); i++)
+    {
+        Solo3v3PackGroup const& group = packGroups[i];
+        GroupQueueInfo* ginfo = packQueued[group.Index];
+
+        switch (group.Result)
+        {
+            case SOLO_PACK_SELECTED:
+                SOLO_3V3_TRACE(bracket_id, SOLO_TRACE_SELECTED, ginfo->Players.begin()->GetCounter(), group.Side, group.Roles[0], group.Size);
+                selectedPlayers += group.Size;
+                break;
+            case SOLO_PACK_REJECT_MMR_WINDOW:
+                SOLO_3V3_TRACE(bracket_id, SOLO_TRACE_REJECT_MMR_WINDOW, ginfo->Players.begin()->GetCounter(), ginfo->teamId, group.Roles[0], group.MMR);
+                break;
+            case SOLO_PACK_REJECT_ROLE_TAKEN:
+                SOLO_3V3_TRACE(bracket_id, SOLO_TRACE_REJECT_ROLE_TAKEN, ginfo->Players.begin()->GetCounter(), ginfo->teamId, group.Roles[0]);
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (!matched)
+    {
+        SOLO_3V3_TRACE(bracket_id, SOLO_TRACE_NO_MATCH, 0, 0, 0, selectedPlayers);
+        return false;
+    }
+
+    for (uint32 i = 0; i < packGroups.size(); i++)
+    {
+        if (packGroups[i].Result != SOLO_PACK_SELECTED)
+            continue;
+
+        GroupQueueInfo* ginfo = packQueued[packGroups[i].Index];
+        if (!queue->m_SelectionPools[packGroups[i].Side].AddGroup(ginfo, SOLO_PACK_TEAM_SIZE)) // added successfully?
+        {
+            SOLO_3V3_TRACE(bracket_id, SOLO_TRACE_REJECT_POOL_FULL, ginfo->Players.begin()->GetCounter(), packGroups[i].Side, packGroups[i].Roles[0]);
+            queue->m_SelectionPools[TEAM_ALLIANCE].Init();
+            queue->m_SelectionPools[TEAM_HORDE].Init();
+            return false;
+        }
+    }
+
+    // Move the picked groups into the queue list of the side they play on, InviteGroupToBG looks them up there
+    for (int side = 0; side < BG_TEAMS_COUNT; side++)
+    {
+        for (auto const& ginfo : queue->m_SelectionPools[side].SelectedGroups)
+        {
+            if (ginfo->teamId == TeamId(side))
+                continue;
+
+            SOLO_3V3_TRACE(bracket_id, SOLO_TRACE_MOVED_FACTION, ginfo->Players.begin()->GetCounter(), side, 0);
+            MoveQueuedGroupToTeam(queue, bracket_id, ginfo, TeamId(side));
+        }
+    }
+
+    SOLO_3V3_TRACE(bracket_id, SOLO_TRACE_MATCH, 0, queue->m_SelectionPools[TEAM_HORDE].GetPlayerCount(), 0, queue->m_SelectionPools[TEAM_ALLIANCE].GetPlayerCount());
+    return true;
+}
+
+void Solo3v3::CollectSolo3v3PackGroups(BattlegroundQueue* queue, BattlegroundBracketId bracket_id)
+{
+    packGroups.clear();
+    packQueued.clear();
+
+    uint32 now = getMSTime();
+
+    for (int teamId = 0; teamId < BG_TEAMS_COUNT; teamId++) // BG_QUEUE_PREMADE_ALLIANCE and BG_QUEUE_PREMADE_HORDE
+    {
+        for (auto const& ginfo : queue->m_QueuedGroups[bracket_id][teamId])
+        {
+            if (ginfo->Players.empty() || ginfo->Players.size() > 2)
                 continue;
 
-            for (auto const& playerGuid : (*itr)->Players)
+            if (ginfo->IsInvitedToBGInstanceGUID) // Skip when invited
             {
-                Player* plr = ObjectAccessor::FindPlayer(playerGuid);
-                if (!plr)
-                    continue;
+                SOLO_3V3_TRACE(bracket_id, SOLO_TRACE_SKIP_INVITED, 0, teamId, 0, ginfo->IsInvitedToBGInstanceGUID);
+                continue;
+            }
 
-                if (!filterTalents && queue->m_SelectionPools[TEAM_ALLIANCE].GetPlayerCount() + queue->m_SelectionPools[TEAM_HORDE].GetPlayerCount() == MinPlayersPerTeam * 2)
-                    return true;
+            Solo3v3PackGroup group;
+            group.MMR = ginfo->ArenaMatchmakerRating;
+            group.Waited = getMSTimeDiff(ginfo->JoinTime, now);
+            group.Size = 0;
+            bool usable = true;
 
+            for (auto const& playerGuid : ginfo->Players)
+            {
+                Player* plr = ObjectAccessor::FindPlayer(playerGuid);
                 if (!plr)
-                    return false;
-
-                Solo3v3TalentCat playerSlotIndex;
-                if (sConfigMgr->GetOption<bool>("Solo.3v3.FilterTalents", false))
-                    playerSlotIndex = GetTalentCatForSolo3v3(plr);
-                else
-                    playerSlotIndex = GetFirstAvailableSlot(soloTeam);
+                {
+                    SOLO_3V3_TRACE(bracket_id, SOLO_TRACE_SKIP_OFFLINE, playerGuid.GetCounter(), teamId);
+                    usable = false;
+                    break;
+                }
 
-                // is slot free in alliance team?
-                if ((filterTalents && soloTeam[TEAM_ALLIANCE][playerSlotIndex] == false) || (!filterTalents && queue->m_SelectionPools[TEAM_ALLIANCE].GetPlayerCount() != MinPlayersPerTeam))
+                if (IsSolo3v3Quarantined(playerGuid, now))
                 {
-                    if (queue->m_SelectionPools[TEAM_ALLIANCE].AddGroup((*itr), MinPlayersPerTeam)) // added successfully?
-                    {
-                        soloTeam[TEAM_ALLIANCE][playerSlotIndex] = true; // okay take this slot
-
-                        if ((*itr)->teamId != TEAM_ALLIANCE) // move to other team
-                        {
-                            (*itr)->teamId = TEAM_ALLIANCE;
-                            (*itr)->GroupType = BG_QUEUE_PREMADE_ALLIANCE;
-                            queue->m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].push_front((*itr));
-                            itr = queue->m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].erase(itr);
-                            return CheckSolo3v3Arena(queue, bracket_id);
-                        }
-                    }
+                    SOLO_3V3_TRACE(bracket_id, SOLO_TRACE_SKIP_QUARANTINED, playerGuid.GetCounter(), teamId);
+                    usable = false;
+                    break;
                 }
-                else if ((filterTalents && soloTeam[TEAM_HORDE][playerSlotIndex] == false) || !filterTalents) // nope? and in horde team?
+
+                if (sSoloInvites->IsHeldBack(playerGuid, group.Waited))
                 {
-                    if (queue->m_SelectionPools[TEAM_HORDE].AddGroup((*itr), MinPlayersPerTeam))
-                    {
-                        soloTeam[TEAM_HORDE][playerSlotIndex] = true;
-
-                        if ((*itr)->teamId != TEAM_HORDE) // move to other team
-                        {
-                            (*itr)->teamId = TEAM_HORDE;
-                            (*itr)->GroupType = BG_QUEUE_PREMADE_HORDE;
-                            queue->m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].push_front((*itr));
-                            itr = queue->m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].erase(itr);
-                            return CheckSolo3v3Arena(queue, bracket_id);
-                        }
-                    }
+                    SOLO_3V3_TRACE(bracket_id, SOLO_TRACE_SKIP_DECLINER, playerGuid.GetCounter(), teamId, 0, group.Waited);
+                    usable = false;
+                    break;
                 }
+
+                group.Roles[group.Size] = config.FilterTalents ? uint8(GetCachedTalentCatForSolo3v3(plr)) : uint8(MELEE);
+
+                SOLO_3V3_TRACE(bracket_id, SOLO_TRACE_CANDIDATE, playerGuid.GetCounter(), teamId, group.Roles[group.Size], ginfo->ArenaMatchmakerRating);
+                group.Size++;
+            }
+
+            if (!usable)
+                continue;
+
+            group.Index = uint32(packQueued.size());
+            packGroups.push_back(group);
+            packQueued.push_back(ginfo);
+        }
+    }
+
+    // Each faction list is in join order, the anchors and the first fit take the oldest of both
+    Solo3v3SortOldestFirst(packGroups);
+}
+
+Battleground* Solo3v3::CreateSolo3v3Arena(BattlegroundQueue* queue, BattlegroundTypeId bgTypeId, PvPDifficultyEntry const* bracketEntry, uint8 arenaType, bool isRated)
+{
+    SOLO_3V3_PROFILE_SCOPE("Solo3v3::CreateSolo3v3Arena");
+
+    uint32 selectedTime = getMSTime();
+
+    Battleground* arena = sBattlegroundMgr->CreateNewBattleground(bgTypeId, bracketEntry, arenaType, isRated);
+    if (!arena)
+        return nullptr;
+
+    // Create temp arena team and store arenaTeamId
+    ArenaTeam* arenaTeams[BG_TEAMS_COUNT];
+    CreateTempArenaTeamForQueue(queue, arenaTeams);
+    uint32 teamsCreatedTime = getMSTime();
+
+    // invite those selection pools
+    for (uint32 i = 0; i < BG_TEAMS_COUNT; i++)
+        for (auto const& citr : queue->m_SelectionPools[TEAM_ALLIANCE + i].SelectedGroups)
+        {
+            citr->ArenaTeamId = arenaTeams[i]->GetId();
+            queue->InviteGroupToBG(citr, arena, citr->teamId);
+
+            for (auto const& playerGuid : citr->Players)
+            {
+                OnQueueLeave(playerGuid);
+                sSoloRemote->SendLeave(playerGuid, bracketEntry->GetBracketId());
             }
         }
+
+    // Override ArenaTeamId to temp arena team (was first set in InviteGroupToBG)
+    arena->SetArenaTeamIdForTeam(TEAM_ALLIANCE, arenaTeams[TEAM_ALLIANCE]->GetId());
+    arena->SetArenaTeamIdForTeam(TEAM_HORDE, arenaTeams[TEAM_HORDE]->GetId());
+
+    // Set matchmaker rating for calculating rating-modifier on EndBattleground (when a team has won/lost)
+    arena->SetArenaMatchmakerRating(TEAM_ALLIANCE, GetAverageMMR(arenaTeams[TEAM_ALLIANCE]));
+    arena->SetArenaMatchmakerRating(TEAM_HORDE, GetAverageMMR(arenaTeams[TEAM_HORDE]));
+
+    Solo3v3ArenaInfo* info = CreateArenaInfo(arena, queue, arenaTeams);
+    info->StageTime[SOLO_STAGE_SELECTED] = selectedTime;
+    info->StageTime[SOLO_STAGE_TEAMS_CREATED] = teamsCreatedTime;
+    info->StageTime[SOLO_STAGE_INVITED] = getMSTime();
+
+    for (uint32 i = 0; i < BG_TEAMS_COUNT; i++)
+    {
+        for (uint8 slot = 0; slot < info->PlayerCount[i]; slot++)
+        {
+            sSoloEvents->Log(SOLO_EVENT_MATCH, info->Players[i][slot].GetCounter(), info->BracketId, info->InstanceId, info->PlayerMMR[i][slot], 0, i, info->Roles[i][slot]);
+
+            if (isRated)
+                if (Player* plr = ObjectAccessor::FindPlayer(info->Players[i][slot]))
+                    SendRatingPreview(*info, i, plr);
+        }
+    }
+
+    // start bg
+    arena->StartBattleground();
+
+    return arena;
+}
+
+void Solo3v3::MoveQueuedGroupToTeam(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, GroupQueueInfo* ginfo, TeamId teamId)
+{
+    if (ginfo->teamId == teamId)
+        return;
+
+    // rated solo groups sit in the premade lists, unrated ones (tournament) in the normal lists
+    bool premade = ginfo->GroupType == BG_QUEUE_PREMADE_ALLIANCE || ginfo->GroupType == BG_QUEUE_PREMADE_HORDE;
+
+    auto& oldList = queue->m_QueuedGroups[bracket_id][ginfo->GroupType];
+    auto oldItr = std::find(oldList.begin(), oldList.end(), ginfo);
+    if (oldItr != oldList.end())
+        oldList.erase(oldItr);
+
+    ginfo->teamId = teamId;
+    if (premade)
+        ginfo->GroupType = teamId == TEAM_ALLIANCE ? BG_QUEUE_PREMADE_ALLIANCE : BG_QUEUE_PREMADE_HORDE;
+    else
+        ginfo->GroupType = teamId == TEAM_ALLIANCE ? BG_QUEUE_NORMAL_ALLIANCE : BG_QUEUE_NORMAL_HORDE;
+    queue->m_QueuedGroups[bracket_id][ginfo->GroupType].push_front(ginfo);
+}
+
+bool Solo3v3::ValidateSolo3v3Selection(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, GroupQueueInfo*& badGroup)
+{
+    // one more than a match can have, so a pool with too many groups is still reported
+    Solo3v3SelectedGroup groups[SOLO_PACK_MATCH_SIZE + 1];
+    GroupQueueInfo* queued[SOLO_PACK_MATCH_SIZE + 1];
+    uint32 count = 0;
+    badGroup = nullptr;
+
+    for (int teamId = 0; teamId < BG_TEAMS_COUNT && count <= SOLO_PACK_MATCH_SIZE; teamId++)
+    {
+        for (auto const& ginfo : queue->m_SelectionPools[teamId].SelectedGroups)
+        {
+            if (count > SOLO_PACK_MATCH_SIZE)
+                break;
+
+            Solo3v3SelectedGroup& group = groups[count];
+            queued[count++] = ginfo;
+
+            group.Key = uint64(uintptr_t(ginfo));
+            group.Side = uint8(teamId);
+            group.Invited = ginfo->IsInvitedToBGInstanceGUID != 0;
+            group.Size = uint8(std::min<size_t>(ginfo->Players.size(), 2));
+
+            for (int listSide = 0; listSide < BG_TEAMS_COUNT; listSide++)
+            {
+                auto const& list = queue->m_QueuedGroups[bracket_id][listSide];
+                if (std::find(list.begin(), list.end(), ginfo) != list.end())
+                    group.ListSide = uint8(listSide);
+            }
+
+            // every selected player must still be in the solo queue of the bracket, a player can only be queued or matched
+            uint8 slot = 0;
+            for (auto const& playerGuid : ginfo->Players)
+            {
+                if (slot >= group.Size)
+                    break;
+
+                auto mirrored = queueMirror.find(playerGuid.GetCounter());
+                Player* plr = ObjectAccessor::FindPlayer(playerGuid);
+
+                group.Players[slot] = playerGuid.GetRawValue();
+                group.Queued[slot] = plr && mirrored != queueMirror.end() && mirrored->second.BracketId == bracket_id;
+                group.Roles[slot] = plr ? uint8(GetCachedTalentCatForSolo3v3(plr)) : uint8(MELEE);
+                slot++;
+            }
+        }
+    }
+
+    Solo3v3SelectionCheck check = Solo3v3CheckSelection(groups, count, config.FilterTalents);
+
+    if (check.Error == SOLO_SELECTION_OK)
+    {
+        for (int teamId = 0; teamId < BG_TEAMS_COUNT; teamId++)
+            if (queue->m_SelectionPools[teamId].GetPlayerCount() != SOLO_PACK_TEAM_SIZE)
+                check.Error = SOLO_SELECTION_TEAM_SIZE;
     }
 
-    uint32 countAll = 0;
-    for (int i = 0; i < BG_TEAMS_COUNT; i++)
-        for (int j = 0; j < MAX_TALENT_CAT; j++)
-            if (soloTeam[i][j])
-                countAll++;
+    if (check.Error == SOLO_SELECTION_OK)
+        return true;
+
+    if (count)
+        badGroup = queued[std::min(check.Group, count - 1)];
+
+    // A broken selection tends to come back every queue update, report it at most every few seconds
+    uint32 now = getMSTime();
+    if (!invalidLogTime[bracket_id] || getMSTimeDiff(invalidLogTime[bracket_id], now) >= SOLO_3V3_INVALID_LOG_INTERVAL)
+    {
+        LOG_ERROR("module", "Solo3v3: dropped selection in bracket {}: {} (group of {}), {} more dropped since the last report",
+            uint32(bracket_id), Solo3v3SelectionErrorText(check.Error), badGroup && !badGroup->Players.empty() ? badGroup->Players.begin()->ToString() : "?", invalidSuppressed[bracket_id]);
+
+        invalidLogTime[bracket_id] = now;
+        invalidSuppressed[bracket_id] = 0;
+    }
+    else
+        invalidSuppressed[bracket_id]++;
+
+    return false;
+}
+
+void Solo3v3::QuarantineSolo3v3Group(GroupQueueInfo* ginfo)
+{
+    uint32 until = getMSTime() + SOLO_3V3_QUARANTINE_TIME;
+
+    for (auto const& playerGuid : ginfo->Players)
+    {
+        quarantined[nextQuarantine] = { playerGuid.GetCounter(), until };
+        nextQuarantine = (nextQuarantine + 1) % SOLO_3V3_QUARANTINE_SLOTS;
+    }
+}
+
+bool Solo3v3::IsSolo3v3Quarantined(ObjectGuid guid, uint32 now) const
+{
+    for (Solo3v3Quarantine const& entry : quarantined)
+        if (entry.Guid == guid.GetCounter() && int32(entry.Until - now) > 0)
+            return true;
 
-    return countAll == MinPlayersPerTeam * 2 || (!filterTalents && queue->m_SelectionPools[TEAM_ALLIANCE].GetPlayerCount() + queue->m_SelectionPools[TEAM_HORDE].GetPlayerCount() == MinPlayersPerTeam * 2);
+    return false;
 }
 
 void Solo3v3::CreateTempArenaTeamForQueue(BattlegroundQueue* queue, ArenaTeam* arenaTeams[])
 {
-    // Create temp arena team
+    SOLO_3V3_PROFILE_SCOPE("Solo3v3::CreateTempArenaTeamForQueue");
+
+    static std::string const teamNames[BG_TEAMS_COUNT] = { "Solo Team - 1", "Solo Team - 2" };
+
+    // Allocates once per match, not per update: the core deletes the temp teams of rated arenas itself,
+    // so they can not be pooled, and CreateTempArenaTeam takes the player list by value
     for (uint32 i = 0; i < BG_TEAMS_COUNT; i++)
     {
         ArenaTeam* tempArenaTeam = new ArenaTeam();  // delete it when all players have left the arena match. Stored in sArenaTeamMgr
         std::vector<Player*> playersList;
+        playersList.reserve(3);
         uint32 atPlrItr = 0;
 
         for (auto const& itr : queue->m_SelectionPools[TEAM_ALLIANCE + i].SelectedGroups)
         {
-            if (atPlrItr >= 3)
-                break; // Should never happen
-
+            // a duo brings both players into the team
             for (auto const& itr2 : itr->Players)
             {
+                if (atPlrItr >= 3)
+                    break; // Should never happen
+
                 auto _PlayerGuid = itr2;
                 if (Player * _player = ObjectAccessor::FindPlayer(_PlayerGuid))
                 {
                     playersList.push_back(_player);
                     atPlrItr++;
                 }
-
-                break;
             }
         }
 
-        std::stringstream ssTeamName;
-        ssTeamName << "Solo Team - " << (i + 1);
-
-        tempArenaTeam->CreateTempArenaTeam(playersList, ARENA_TEAM_SOLO_3v3, ssTeamName.str());
+        tempArenaTeam->CreateTempArenaTeam(playersList, ARENA_TEAM_SOLO_3v3, teamNames[i]);
         sArenaTeamMgr->AddArenaTeam(tempArenaTeam);
         arenaTeams[i] = tempArenaTeam;
     }
 }
 
+Solo3v3ArenaInfo* Solo3v3::CreateArenaInfo(Battleground* arena, BattlegroundQueue* queue, ArenaTeam* arenaTeams[])
+{
+    Solo3v3ArenaInfo& info = arenaInfos[arena->GetInstanceID()];
+    info = Solo3v3ArenaInfo();
+    info.InstanceId = arena->GetInstanceID();
+    info.BracketId = arena->GetBracketId();
+    info.CreateTime = GameTime::GetGameTimeMS().count();
+
+    for (uint32 i = 0; i < BG_TEAMS_COUNT; i++)
+    {
+        info.ArenaTeamIds[i] = arenaTeams[i]->GetId();
+        info.TeamMMR[i] = GetAverageMMR(arenaTeams[i]);
+        info.TempTeamBytes += sizeof(ArenaTeam) + arenaTeams[i]->GetMembersSize() * sizeof(ArenaTeamMember);
+
+        for (auto const& ginfo : queue->m_SelectionPools[TEAM_ALLIANCE + i].SelectedGroups)
+        {
+            for (auto const& playerGuid : ginfo->Players)
+            {
+                if (info.PlayerCount[i] >= 3)
+                    break;
+
+                uint8 slot = info.PlayerCount[i]++;
+                info.Players[i][slot] = playerGuid;
+                info.PlayerMMR[i][slot] = ginfo->ArenaMatchmakerRating;
+
+                if (!info.StageTime[SOLO_STAGE_QUEUE_JOIN] || ginfo->JoinTime < info.StageTime[SOLO_STAGE_QUEUE_JOIN])
+                    info.StageTime[SOLO_STAGE_QUEUE_JOIN] = ginfo->JoinTime;
+
+                if (Player* plr = ObjectAccessor::FindPlayer(playerGuid))
+                    info.Roles[i][slot] = GetCachedTalentCatForSolo3v3(plr);
+            }
+        }
+    }
+
+    // The weekly arena points pay the role bonus of when the match formed, not of distribution time
+    if (config.RoleBonusEnable && arena->isRated())
+    {
+        uint32 now = uint32(GameTime::GetGameTime().count());
+        CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
+
+        for (uint32 i = 0; i < BG_TEAMS_COUNT; i++)
+        {
+            for (uint8 slot = 0; slot < info.PlayerCount[i]; slot++)
+            {
+                Solo3v3PlayedReward& played = lastPlayed[info.Players[i][slot].GetCounter()];
+                played.Multiplier = roleRewardMultipliers[info.BracketId][info.Roles[i][slot]];
+                played.Time = now;
+
+                trans->Append(GetSolo3v3Statement(SOLO_REP_ROLE_REWARD), info.Players[i][slot].GetCounter(), played.Multiplier, played.Time);
+            }
+        }
+
+        CharacterDatabase.CommitTransaction(trans);
+    }
+
+    tempTeamCount += BG_TEAMS_COUNT;
+    tempTeamBytes += info.TempTeamBytes;
+
+    UpdateExpectedRatingChanges(info);
+    return &info;
+}
+
+void Solo3v3::UpdateExpectedRatingChanges(Solo3v3ArenaInfo& info) const
+{
+    // Same formula the core applies to the temp team when the arena ends
+    for (uint32 i = 0; i < BG_TEAMS_COUNT; i++)
+    {
+        ArenaTeam* team = sArenaTeamMgr->GetArenaTeamById(info.ArenaTeamIds[i]);
+        if (!team)
+            continue;
+
+        uint32 opponentMMR = info.TeamMMR[BG_TEAMS_COUNT - 1 - i];
+        info.ExpectedGain[i] = team->GetRatingMod(team->GetRating(), opponentMMR, true);
+        info.ExpectedLoss[i] = team->GetRatingMod(team->GetRating(), opponentMMR, false);
+    }
+}
+
+void Solo3v3::OnSolo3v3PlayerEntered(Battleground* bg, Player* player)
+{
+    Solo3v3ArenaInfo* info = GetArenaInfo(bg->GetInstanceID());
+    if (!info || info->StageTime[SOLO_STAGE_ACCEPTED])
+        return;
+
+    uint32 now = getMSTime();
+    bool allAccepted = true;
+
+    for (uint32 teamId = 0; teamId < BG_TEAMS_COUNT; teamId++)
+    {
+        for (uint8 slot = 0; slot < info->PlayerCount[teamId]; slot++)
+        {
+            if (!info->AcceptTime[teamId][slot] && info->Players[teamId][slot] == player->GetGUID())
+            {
+                info->AcceptTime[teamId][slot] = now;
+                sSoloInvites->OnAccepted(player->GetGUID());
+            }
+
+            allAccepted = allAccepted && info->AcceptTime[teamId][slot];
+        }
+    }
+
+    if (allAccepted)
+        info->StageTime[SOLO_STAGE_ACCEPTED] = now;
+}
+
+void Solo3v3::UpdateSolo3v3Stages(Battleground* bg)
+{
+    Solo3v3MatchStage stage;
+    if (bg->GetStatus() == STATUS_IN_PROGRESS)
+        stage = SOLO_STAGE_GATES_OPEN;
+    else if (bg->GetStatus() == STATUS_WAIT_LEAVE)
+        stage = SOLO_STAGE_MATCH_END;
+    else
+        return;
+
+    Solo3v3ArenaInfo* info = GetArenaInfo(bg->GetInstanceID());
+    if (info && !info->StageTime[stage])
+        info->StageTime[stage] = getMSTime();
+
+    if (info)
+        ResolveSolo3v3Invites(*info);
+}
+
+void Solo3v3::ResolveSolo3v3Invites(Solo3v3ArenaInfo& info)
+{
+    if (info.InvitesResolved)
+        return;
+
+    info.InvitesResolved = true;
+
+    // Accepts were counted on entering, whoever has not entered by now let the invite go
+    for (uint32 teamId = 0; teamId < BG_TEAMS_COUNT; teamId++)
+        for (uint8 slot = 0; slot < info.PlayerCount[teamId]; slot++)
+            if (!info.AcceptTime[teamId][slot])
+                sSoloInvites->OnDeclined(info.Players[teamId][slot]);
+}
+
+Solo3v3ArenaInfo* Solo3v3::GetArenaInfo(uint32 instanceId)
+{
+    auto itr = arenaInfos.find(instanceId);
+    return itr != arenaInfos.end() ? &itr->second : nullptr;
+}
+
+void Solo3v3::RemoveArenaInfo(uint32 instanceId)
+{
+    arenaInfos.erase(instanceId);
+}
+
+void Solo3v3::OnQueueJoin(ObjectGuid guid, BattlegroundBracketId bracket_id, Solo3v3TalentCat role, uint32 mmr)
+{
+    OnQueueLeave(guid);
+
+    Solo3v3QueuedPlayer& queued = queueMirror[guid.GetCounter()];
+    queued.BracketId = bracket_id;
+    queued.Role = role;
+    queued.MMR = mmr;
+
+    queuedRoles[bracket_id][role]++;
+    sSoloRating->OnQueueJoin(bracket_id, mmr);
+}
+
+void Solo3v3::OnQueueLeave(ObjectGuid guid)
+{
+    auto itr = queueMirror.find(guid.GetCounter());
+    if (itr == queueMirror.end())
+        return;
+
+    uint32& count = queuedRoles[itr->second.BracketId][itr->second.Role];
+    if (count)
+        count--;
+
+    sSoloRating->OnQueueLeave(itr->second.BracketId, itr->second.MMR);
+    queueMirror.erase(itr);
+}
+
+void Solo3v3::ReserveCapacity(uint32 matches, uint32 players)
+{
+    arenaInfos.reserve(arenaInfos.size() + matches);
+    queueMirror.reserve(queueMirror.size() + players);
+}
+
+void Solo3v3::SendRatingPreview(Solo3v3ArenaInfo const& info, uint32 teamId, Player* player) const
+{
+    ChatHandler(player->GetSession()).PSendSysMessage("Solo arena found, team MMR %u vs %u. A win gives %+d rating, a loss %+d.",
+        info.TeamMMR[teamId], info.TeamMMR[BG_TEAMS_COUNT - 1 - teamId], info.ExpectedGain[teamId], info.ExpectedLoss[teamId]);
+}
+
+void Solo3v3::RebuildQueueMirror()
+{
+    BattlegroundQueue& queue = sBattlegroundMgr->GetBattlegroundQueue(bgQueueTypeId);
+
+    queueMirror.clear();
+    memset(queuedRoles, 0, sizeof(queuedRoles));
+    sSoloRating->ClearQueued();
+
+    for (int bracket = BG_BRACKET_ID_FIRST; bracket <= BG_BRACKET_ID_LAST; bracket++)
+        for (int teamId = 0; teamId < BG_TEAMS_COUNT; teamId++)
+            for (auto const& ginfo : queue.m_QueuedGroups[bracket][teamId])
+            {
+                if (ginfo->ArenaType != ARENA_TYPE_3v3_SOLO || ginfo->IsInvitedToBGInstanceGUID)
+                    continue;
+
+                for (auto const& playerGuid : ginfo->Players)
+                    if (Player* plr = ObjectAccessor::FindPlayer(playerGuid))
+                        OnQueueJoin(playerGuid, BattlegroundBracketId(bracket), GetCachedTalentCatForSolo3v3(plr), ginfo->ArenaMatchmakerRating);
+            }
+}
+
+void Solo3v3::UpdateRoleRewards(uint32 diff)
+{
+    if (!config.RoleBonusEnable)
+        return;
+
+    roleRewardTimer += diff;
+    if (roleRewardTimer < config.RoleBonusInterval)
+        return;
+
+    roleRewardTimer = 0;
+
+    // Every 10th run the mirror is rebuilt from the queue, in case a removal path was missed,
+    // and the role rewards older than the weekly distribution are dropped
+    if (++roleRewardUpdates % 10 == 0)
+    {
+        RebuildQueueMirror();
+
+        uint32 now = uint32(GameTime::GetGameTime().count());
+        for (auto itr = lastPlayed.begin(); itr != lastPlayed.end();)
+        {
+            if (now - itr->second.Time >= WEEK)
+                itr = lastPlayed.erase(itr);
+            else
+                ++itr;
+        }
+    }
+
+    // Each match takes one player of every role per team when talents are filtered, so a role below the
+    // average count of all roles is the one holding the queue up. Without the filter roles don't matter.
+    for (uint32 bracket = 0; bracket < MAX_BATTLEGROUND_BRACKETS; bracket++)
+    {
+        uint32 total = queuedRoles[bracket][MELEE] + queuedRoles[bracket][RANGE] + queuedRoles[bracket][HEALER];
+        float average = float(total) / MAX_TALENT_CAT;
+
+        for (uint32 role = 0; role < MAX_TALENT_CAT; role++)
+        {
+            float multiplier = 1.0f;
+            if (config.FilterTalents && average > 0.0f && queuedRoles[bracket][role] < average)
+                multiplier += config.RoleBonusFactor * (average - queuedRoles[bracket][role]) / average;
+
+            roleRewardMultipliers[bracket][role] = std::min(multiplier, config.RoleBonusMax);
+        }
+    }
+}
+
+float Solo3v3::GetArenaPointsMultiplier(ObjectGuid captain) const
+{
+    if (!config.RoleBonusEnable)
+        return config.ArenaPointsMulti;
+
+    auto itr = lastPlayed.find(captain.GetCounter());
+    if (itr == lastPlayed.end() || uint32(GameTime::GetGameTime().count()) - itr->second.Time >= WEEK)
+        return config.ArenaPointsMulti;
+
+    return config.ArenaPointsMulti * itr->second.Multiplier;
+}
+
+void Solo3v3::LoadRoleRewards()
+{
+    uint32 oldMSTime = getMSTime();
+    uint32 weekAgo = uint32(GameTime::GetGameTime().count()) - WEEK;
+
+    lastPlayed.clear();
+    CharacterDatabase.Execute(GetSolo3v3Statement(SOLO_DEL_ROLE_REWARDS), weekAgo);
+
+    QueryResult result = CharacterDatabase.Query(GetSolo3v3Statement(SOLO_SEL_ROLE_REWARDS), weekAgo);
+    if (!result)
+        return;
+
+    lastPlayed.reserve(result->GetRowCount());
+
+    do
+    {
+        Field* fields = result->Fetch();
+
+        Solo3v3PlayedReward& played = lastPlayed[fields[0].Get<uint32>()];
+        played.Multiplier = fields[1].Get<float>();
+        played.Time = fields[2].Get<uint32>();
+    } while (result->NextRow());
+
+    LOG_INFO("module", ">> Loaded {} solo 3v3 role rewards in {} ms", lastPlayed.size(), GetMSTimeDiffToNow(oldMSTime));
+}
+
 bool Solo3v3::Arena3v3CheckTalents(Player* player)
 {
     if (!player)
@@ -367,11 +1133,18 @@ bool Solo3v3::Arena3v3CheckTalents(Player* player)
 
 Solo3v3TalentCat Solo3v3::GetTalentCatForSolo3v3(Player* player)
 {
+    SOLO_3V3_PROFILE_SCOPE("Solo3v3::GetTalentCatForSolo3v3");
+
     uint32 count[MAX_TALENT_CAT];
 
     for (int i = 0; i < MAX_TALENT_CAT; i++)
         count[i] = 0;
 
+    // held for the whole lookup, a reload meanwhile frees the old table only after it, see Solo3v3RoleMap
+    std::shared_ptr<Solo3v3RoleTable const> roles = sSoloRoles->GetTable();
+    if (!roles)
+        return MELEE;
+
     for (uint32 talentId = 0; talentId < sTalentStore.GetNumRows(); ++talentId)
     {
         TalentEntry const* talentInfo = sTalentStore.LookupEntry(talentId);
@@ -379,25 +1152,17 @@ Solo3v3TalentCat Solo3v3::GetTalentCatForSolo3v3(Player* player)
         if (!talentInfo)
             continue;
 
+        int8 role = roles->GetRole(talentInfo->TalentTab);
+        if (role == Solo3v3RoleTable::NO_ROLE)
+            continue;
+
         for (int8 rank = MAX_TALENT_RANK - 1; rank >= 0; --rank)
         {
             if (talentInfo->RankID[rank] == 0)
                 continue;
 
             if (player->HasTalent(talentInfo->RankID[rank], player->GetActiveSpec()))
-            {
-                for (int8 i = 0; SOLO_3V3_TALENTS_MELEE[i] != 0; i++)
-                    if (SOLO_3V3_TALENTS_MELEE[i] == talentInfo->TalentTab)
-                        count[MELEE] += rank + 1;
-
-                for (int8 i = 0; SOLO_3V3_TALENTS_RANGE[i] != 0; i++)
-                    if (SOLO_3V3_TALENTS_RANGE[i] == talentInfo->TalentTab)
-                        count[RANGE] += rank + 1;
-
-                for (int8 i = 0; SOLO_3V3_TALENTS_HEAL[i] != 0; i++)
-                    if (SOLO_3V3_TALENTS_HEAL[i] == talentInfo->TalentTab)
-                        count[HEALER] += rank + 1;
-            }
+                count[role] += rank + 1;
         }
     }
 
@@ -417,15 +1182,112 @@ Solo3v3TalentCat Solo3v3::GetTalentCatForSolo3v3(Player* player)
     return talCat;
 }
 
-Solo3v3TalentCat Solo3v3::GetFirstAvailableSlot(bool soloTeam[][MAX_TALENT_CAT]) {
-    if (!soloTeam[0][MELEE] || !soloTeam[1][MELEE])
-        return MELEE;
+Solo3v3TalentCat Solo3v3::GetCachedTalentCatForSolo3v3(Player* player)
+{
+    if (std::this_thread::get_id() != worldThread)
+        return GetTalentCatForSolo3v3(player);
+
+    ApplyTalentCatInvalidations();
+
+    ObjectGuid::LowType guid = player->GetGUID().GetCounter();
+    Solo3v3TalentCatSlot& slot = talentCatCache[guid & (SOLO_3V3_TALENT_CACHE_SLOTS - 1)];
+    if (slot.Guid != guid)
+    {
+        slot.Guid = guid;
+        slot.Cat = GetTalentCatForSolo3v3(player);
+    }
 
-    if (!soloTeam[0][RANGE] || !soloTeam[1][RANGE])
-        return RANGE;
+    return slot.Cat;
+}
+
+void Solo3v3::InvalidateTalentCat(ObjectGuid guid)
+{
+    std::lock_guard<std::mutex> lock(talentCatLock);
 
-    if (!soloTeam[0][HEALER] || !soloTeam[1][HEALER])
-        return HEALER;
+    uint32 pending = talentCatPending.load(std::memory_order_relaxed);
+    if (talentCatClearAll)
+        return;
+
+    if (pending < SOLO_3V3_TALENT_INVALIDATIONS)
+        talentCatInvalidated[pending] = guid.GetCounter();
+    else
+        talentCatClearAll = true;
+
+    talentCatPending.store(pending + 1, std::memory_order_release);
+}
+
+void Solo3v3::InvalidateAllTalentCats()
+{
+    std::lock_guard<std::mutex> lock(talentCatLock);
+    talentCatClearAll = true;
+    talentCatPending.fetch_add(1, std::memory_order_release);
+}
+
+void Solo3v3::ApplyTalentCatInvalidations()
+{
+    if (!talentCatPending.load(std::memory_order_acquire))
+        return;
+
+    bool clearAll;
+    {
+        std::lock_guard<std::mutex> lock(talentCatLock);
+        uint32 pending = std::min(talentCatPending.load(std::memory_order_relaxed), SOLO_3V3_TALENT_INVALIDATIONS);
+        clearAll = talentCatClearAll;
+
+        if (clearAll)
+        {
+            for (Solo3v3TalentCatSlot& slot : talentCatCache)
+                slot.Guid = 0;
+        }
+        else
+        {
+            for (uint32 i = 0; i < pending; i++)
+            {
+                Solo3v3TalentCatSlot& slot = talentCatCache[talentCatInvalidated[i] & (SOLO_3V3_TALENT_CACHE_SLOTS - 1)];
+                if (slot.Guid == talentCatInvalidated[i])
+                    slot.Guid = 0;
+            }
+        }
+
+        talentCatClearAll = false;
+        talentCatPending.store(0, std::memory_order_relaxed);
+    }
+
+    // queued players were counted under their old role
+    if (clearAll)
+        RebuildQueueMirror();
+}
+
+void Solo3v3::ReportMemory(Solo3v3MemoryReport& report, bool walkTempTeams) const
+{
+    report.Add("arena contexts", Solo3v3HashBytes(arenaInfos), arenaInfos.size());
+    uint32 cachedRoles = 0;
+    for (Solo3v3TalentCatSlot const& slot : talentCatCache)
+        cachedRoles += slot.Guid ? 1 : 0;
+
+    report.Add("talent role cache", sizeof(talentCatCache), cachedRoles);
+    report.Add("queue mirror", Solo3v3HashBytes(queueMirror), queueMirror.size());
+    report.Add("last played roles", Solo3v3HashBytes(lastPlayed), lastPlayed.size());
+    report.Add("matcher groups", Solo3v3VectorBytes(packGroups) + Solo3v3VectorBytes(packQueued), packGroups.size());
+
+    // Owned by the arena team manager, but created and deleted by this module
+    if (!walkTempTeams)
+    {
+        report.Add("temp arena teams", tempTeamBytes, tempTeamCount);
+        return;
+    }
+
+    size_t teams = 0;
+    size_t bytes = 0;
+
+    for (auto const& itr : sArenaTeamMgr->GetArenaTeams())
+    {
+        if (itr.first < MAX_ARENA_TEAM_ID || itr.second->GetType() != ARENA_TEAM_SOLO_3v3)
+            continue;
+
+        teams++;
+        bytes += sizeof(ArenaTeam) + itr.second->GetMembersSize() * sizeof(ArenaTeamMember);
+    }
 
-    return MELEE;
+    report.Add("temp arena teams", bytes, teams);
 }
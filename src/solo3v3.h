@@ -22,6 +22,10 @@
 #include "ArenaTeamMgr.h"
 #include "BattlegroundMgr.h"
 #include "Player.h"
+#include "solo3v3_pack.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 // Custom 1v1 Arena Rated
 constexpr uint32 ARENA_TYPE_1v1 = 1;
@@ -37,6 +41,17 @@ constexpr uint32 ARENA_SLOT_SOLO_3v3 = 4;
 constexpr uint32 BATTLEGROUND_QUEUE_3v3_SOLO = 12;
 constexpr BattlegroundQueueTypeId bgQueueTypeId = (BattlegroundQueueTypeId)((int)BATTLEGROUND_QUEUE_3v3);
 
+// A group in a selection that failed ValidateSolo3v3Selection is left out of matching this long
+constexpr uint32 SOLO_3V3_QUARANTINE_TIME = 60 * IN_MILLISECONDS;
+constexpr uint32 SOLO_3V3_QUARANTINE_SLOTS = 16;
+constexpr uint32 SOLO_3V3_INVALID_LOG_INTERVAL = 10 * IN_MILLISECONDS;
+
+// Talent role cache: direct mapped by guid (power of two), a collision only costs a recomputation
+constexpr uint32 SOLO_3V3_TALENT_CACHE_SLOTS = 4096;
+// Invalidations queued by map threads until the world thread applies them, more clear the whole cache
+constexpr uint32 SOLO_3V3_TALENT_INVALIDATIONS = 256;
+
+class Solo3v3MemoryReport;
 
 const uint32 FORBIDDEN_TALENTS_IN_1V1_ARENA[] =
 {
@@ -50,6 +65,7 @@ const uint32 FORBIDDEN_TALENTS_IN_1V1_ARENA[] =
 };
 
 // SOLO_3V3_TALENTS found in: TalentTab.dbc -> TalentTabID
+// Built-in roles, only used while the world table solo_3v3_talent_role is empty (see Solo3v3RoleMap)
 // Warrior, Rogue, Deathknight etc.
 const uint32 SOLO_3V3_TALENTS_MELEE[] =
 {
@@ -107,24 +123,205 @@ enum Solo3v3TalentCat
 
 #define BG_TEAMS_COUNT 2
 
+// Config values read on hot paths (queue update, battleground update, gossip).
+// Looked up once in LoadConfig(), as every sConfigMgr->GetOption builds a std::string key.
+struct Solo3v3Config
+{
+    bool Enable = true;
+    bool FilterTalents = false;
+    bool ValidateMatches = true;
+    bool AllowDuoQueue = false;
+    bool CastDeserterOnAfk = true;
+    bool StopGameIncomplete = true;
+    bool BackfillEnable = false;
+    uint32 BackfillMaxMMRDifference = 300;
+    uint32 BackfillMinTimeLeft = 15000;                     // ms of preparation left, a replacement needs time to accept
+    bool RoleBonusEnable = false;
+    float RoleBonusFactor = 0.5f;
+    float RoleBonusMax = 1.5f;
+    uint32 RoleBonusInterval = 30000;                       // ms between two recalculations of the multipliers
+    uint32 Cost = 1;
+    float ArenaPointsMulti = 0.8f;
+};
+
+// Lifecycle stages of a solo arena, in the order they are reached
+enum Solo3v3MatchStage : uint8
+{
+    SOLO_STAGE_QUEUE_JOIN = 0,                              // oldest queue join of the players
+    SOLO_STAGE_SELECTED,                                    // match picked by the matcher
+    SOLO_STAGE_TEAMS_CREATED,                               // battleground and temp arena teams created
+    SOLO_STAGE_INVITED,                                     // invites sent
+    SOLO_STAGE_ACCEPTED,                                    // last player entered the arena
+    SOLO_STAGE_GATES_OPEN,
+    SOLO_STAGE_MATCH_END,
+    SOLO_STAGE_RATINGS_SAVED,
+    MAX_SOLO_STAGES
+};
+
+// Per-arena context of a running solo arena, created when the match pops and dropped with the battleground
+struct Solo3v3ArenaInfo
+{
+    uint32 InstanceId = 0;
+    BattlegroundBracketId BracketId = BG_BRACKET_ID_FIRST;
+    uint32 CreateTime = 0;                                  // GameTime::GetGameTimeMS()
+    uint32 ArenaTeamIds[BG_TEAMS_COUNT] = { };              // temp arena teams
+    uint32 TempTeamBytes = 0;                               // of both temp teams, counted until CleanUp3v3SoloQ
+    uint32 TeamMMR[BG_TEAMS_COUNT] = { };
+    uint8 PlayerCount[BG_TEAMS_COUNT] = { };
+    ObjectGuid Players[BG_TEAMS_COUNT][3];
+    Solo3v3TalentCat Roles[BG_TEAMS_COUNT][3] = { };
+    uint32 PlayerMMR[BG_TEAMS_COUNT][3] = { };
+    uint32 NextBackfillCheck = 0;                           // GameTime::GetGameTimeMS(), backfill looks at most once per second
+    int32 ExpectedGain[BG_TEAMS_COUNT] = { };               // team rating change on a win, fixed when the match pops or is backfilled
+    int32 ExpectedLoss[BG_TEAMS_COUNT] = { };               // and on a loss, SaveSoloDB applies exactly these
+    bool RatingSaved[BG_TEAMS_COUNT][3] = { };              // SaveSoloDB ran for the slot
+    uint32 StageTime[MAX_SOLO_STAGES] = { };                // getMSTime() a stage was reached, 0 = not yet
+    uint32 AcceptTime[BG_TEAMS_COUNT][3] = { };             // getMSTime() each player entered the arena
+    bool InvitesResolved = false;                           // declines counted (gates open or arena destroyed)
+};
+
+// Role reward a player earned with the last rated solo arena, the multiplier of the role when the match formed
+struct Solo3v3PlayedReward
+{
+    float Multiplier = 1.0f;
+    uint32 Time = 0;                                        // unix time the match formed, forgotten after a week
+};
+
+// A player waiting in the solo queue. Mirrored on join and leave, so nothing has to walk the queue to count roles.
+struct Solo3v3QueuedPlayer
+{
+    BattlegroundBracketId BracketId = BG_BRACKET_ID_FIRST;
+    Solo3v3TalentCat Role = MELEE;
+    uint32 MMR = 0;
+};
+
 class Solo3v3
 {
 public:
     static Solo3v3* instance();
 
-    void SaveSoloDB(ArenaTeam* team);
+    void LoadConfig();
+    Solo3v3Config const& GetConfig() const { return config; }
+
+    // Writes the previewed rating change of a player of a rated solo arena into the own solo team, once per slot.
+    // winner TEAM_NEUTRAL counts as a loss, like a draw or leaving the running arena.
+    void SaveSoloDB(Battleground* bg, ObjectGuid guid, TeamId winner);
     uint32 GetAverageMMR(ArenaTeam* team);
     void CheckStartSolo3v3Arena(Battleground* bg);
+
+    // During preparation: replaces players that left or let the invite expire by a queued player of the same role
+    void BackfillSolo3v3Arena(Battleground* bg);
+    // Stage timestamps of the arena context: players entering, gates opening and the match ending
+    void OnSolo3v3PlayerEntered(Battleground* bg, Player* player);
+    void UpdateSolo3v3Stages(Battleground* bg);
+    // Counts every player that has not entered the arena as a declined invite, once per arena
+    void ResolveSolo3v3Invites(Solo3v3ArenaInfo& info);
     void CleanUp3v3SoloQ(Battleground* bg);
     bool CheckSolo3v3Arena(BattlegroundQueue* queue, BattlegroundBracketId bracket_id);
     void CreateTempArenaTeamForQueue(BattlegroundQueue* queue, ArenaTeam* arenaTeams[]);
 
+    // Creates the arena for the groups in the selection pools: temp teams, invites, MMR and arena context
+    Battleground* CreateSolo3v3Arena(BattlegroundQueue* queue, BattlegroundTypeId bgTypeId, PvPDifficultyEntry const* bracketEntry, uint8 arenaType, bool isRated);
+
+    // Moves a queued group into the queue list of the given side, like the faction swap in CheckSolo3v3Arena
+    void MoveQueuedGroupToTeam(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, GroupQueueInfo* ginfo, TeamId teamId);
+
+    // Return false, if the selection pools filled by CheckSolo3v3Arena break a matcher invariant (Solo3v3CheckSelection),
+    // badGroup is then the group the check failed at. Failures are logged at most every SOLO_3V3_INVALID_LOG_INTERVAL per bracket.
+    bool ValidateSolo3v3Selection(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, GroupQueueInfo*& badGroup);
+    // Keeps the players of the group out of the matcher for SOLO_3V3_QUARANTINE_TIME, so a broken selection is not retried every update
+    void QuarantineSolo3v3Group(GroupQueueInfo* ginfo);
+    bool IsSolo3v3Quarantined(ObjectGuid guid, uint32 now) const;
+
     // Return false, if player have invested more than 35 talentpoints in a forbidden talenttree.
     bool Arena3v3CheckTalents(Player* player);
 
     // Returns MELEE, RANGE or HEALER (depends on talent builds)
     Solo3v3TalentCat GetTalentCatForSolo3v3(Player* player);
-    Solo3v3TalentCat GetFirstAvailableSlot(bool soloTeam[][MAX_TALENT_CAT]);
+
+    // Same as GetTalentCatForSolo3v3, but remembered per player until the talents change.
+    // The cache belongs to the world thread (BindWorldThread), other threads get the role computed.
+    Solo3v3TalentCat GetCachedTalentCatForSolo3v3(Player* player);
+    void BindWorldThread() { worldThread = std::this_thread::get_id(); }
+    // Safe from any thread, applied by the world thread on its next lookup
+    void InvalidateTalentCat(ObjectGuid guid);
+    // After the talent role mapping changed (Solo3v3RoleMap::Load)
+    void InvalidateAllTalentCats();
+    // World thread: applies the queued invalidations, every lookup and world update does
+    void ApplyTalentCatInvalidations();
+
+    // Per-arena context, keyed by battleground instance id
+    Solo3v3ArenaInfo* CreateArenaInfo(Battleground* arena, BattlegroundQueue* queue, ArenaTeam* arenaTeams[]);
+    Solo3v3ArenaInfo* GetArenaInfo(uint32 instanceId);
+    void RemoveArenaInfo(uint32 instanceId);
+    std::unordered_map<uint32, Solo3v3ArenaInfo> const& GetArenaInfos() const { return arenaInfos; }
+
+    // Queue mirror, fed wherever a player enters or leaves the solo queue (join, leave, logout, invite)
+    void OnQueueJoin(ObjectGuid guid, BattlegroundBracketId bracket_id, Solo3v3TalentCat role, uint32 mmr);
+    void OnQueueLeave(ObjectGuid guid);
+    uint32 GetQueuedRoleCount(BattlegroundBracketId bracket_id, Solo3v3TalentCat role) const { return queuedRoles[bracket_id][role]; }
+
+    // Reward multipliers of scarce roles, recalculated every Solo.3v3.RoleBonus.Interval from the mirror counters
+    void UpdateRoleRewards(uint32 diff);
+    float GetRoleRewardMultiplier(BattlegroundBracketId bracket_id, Solo3v3TalentCat role) const { return roleRewardMultipliers[bracket_id][role]; }
+    // Weekly arena point multiplier of a solo team: Solo.3v3.ArenaPointsMulti times the role reward of the captain's
+    // last rated solo arena of the past week
+    float GetArenaPointsMultiplier(ObjectGuid captain) const;
+    // Startup load of the role rewards of the past week (solo_3v3_role_reward)
+    void LoadRoleRewards();
+    // Reserves the arena contexts and queue mirror for the matches and joins expected soon (Solo3v3Forecast)
+    void ReserveCapacity(uint32 matches, uint32 players);
+    // Bytes held by the arena contexts, caches, queue mirror and the temp arena teams (Solo3v3MemoryStats).
+    // The temp teams come from running totals, walkTempTeams counts them in the arena team manager instead.
+    void ReportMemory(Solo3v3MemoryReport& report, bool walkTempTeams) const;
+
+private:
+    // Copies the groups of the bracket that can play right now into packGroups for Solo3v3FindMatch, oldest first
+    void CollectSolo3v3PackGroups(BattlegroundQueue* queue, BattlegroundBracketId bracket_id);
+    Solo3v3Config config;
+    std::unordered_map<uint32, Solo3v3ArenaInfo> arenaInfos;
+
+    struct Solo3v3TalentCatSlot
+    {
+        ObjectGuid::LowType Guid = 0;                                           // 0 = empty
+        Solo3v3TalentCat Cat = MELEE;
+    };
+
+    Solo3v3TalentCatSlot talentCatCache[SOLO_3V3_TALENT_CACHE_SLOTS];
+    std::thread::id worldThread;
+    std::mutex talentCatLock;                                                   // guards the two below
+    ObjectGuid::LowType talentCatInvalidated[SOLO_3V3_TALENT_INVALIDATIONS] = { };
+    bool talentCatClearAll = false;
+    std::atomic<uint32> talentCatPending{ 0 };                                  // queued invalidations, clear all counts as one
+
+    void RebuildQueueMirror();
+    // Sets ExpectedGain and ExpectedLoss of both teams from their temp teams and the current TeamMMR
+    void UpdateExpectedRatingChanges(Solo3v3ArenaInfo& info) const;
+    // Tells the player what the arena of the context is worth, see Solo3v3ArenaInfo::ExpectedGain
+    void SendRatingPreview(Solo3v3ArenaInfo const& info, uint32 teamId, Player* player) const;
+
+    std::unordered_map<ObjectGuid::LowType, Solo3v3QueuedPlayer> queueMirror;
+    uint32 queuedRoles[MAX_BATTLEGROUND_BRACKETS][MAX_TALENT_CAT] = { };
+    float roleRewardMultipliers[MAX_BATTLEGROUND_BRACKETS][MAX_TALENT_CAT];
+    std::unordered_map<ObjectGuid::LowType, Solo3v3PlayedReward> lastPlayed;    // role reward of the last rated solo arena
+    std::vector<Solo3v3PackGroup> packGroups;                                   // reused every queue update
+    std::vector<GroupQueueInfo*> packQueued;                                    // queue entry of packGroups[i]
+    uint32 tempTeamCount = 0;                                                   // temp arena teams created and not cleaned up
+    size_t tempTeamBytes = 0;                                                   // and their bytes, see Solo3v3ArenaInfo::TempTeamBytes
+
+    struct Solo3v3Quarantine
+    {
+        ObjectGuid::LowType Guid = 0;
+        uint32 Until = 0;                                                       // getMSTime()
+    };
+
+    Solo3v3Quarantine quarantined[SOLO_3V3_QUARANTINE_SLOTS];
+    uint32 nextQuarantine = 0;
+    uint32 invalidLogTime[MAX_BATTLEGROUND_BRACKETS] = { };
+    uint32 invalidSuppressed[MAX_BATTLEGROUND_BRACKETS] = { };
+
+    uint32 roleRewardTimer = 0;
+    uint32 roleRewardUpdates = 0;
 };
 
 #define sSolo Solo3v3::instance()
@@ -0,0 +1,390 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_archive.h"
+#include "solo3v3_db.h"
+#include "Config.h"
+#include "DatabaseEnv.h"
+#include "GameTime.h"
+#include "Log.h"
+#include "World.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+static std::atomic<uint32> SeasonStart{ 0 };
+
+// At most one archive is written at a time, joined before the next one starts and on shutdown
+static std::mutex ArchiveWriterLock;
+static std::thread ArchiveWriterThread;
+static std::shared_ptr<std::atomic<bool>> ArchiveWriterDone;
+
+namespace
+{
+    struct ArchiveColumn
+    {
+        std::string Name;
+        std::vector<int64> Values;
+        std::vector<uint64> BlockOffsets;
+    };
+
+    struct ArchiveTable
+    {
+        std::string Name;
+        std::vector<ArchiveColumn> Columns;
+
+        explicit ArchiveTable(std::string name, std::initializer_list<char const*> columns) : Name(std::move(name))
+        {
+            for (char const* column : columns)
+                Columns.push_back({ column, { }, { } });
+        }
+
+        void AddRow(std::initializer_list<int64> values)
+        {
+            size_t i = 0;
+            for (int64 value : values)
+                Columns[i++].Values.push_back(value);
+        }
+
+        uint32 GetRows() const { return Columns.empty() ? 0 : uint32(Columns.front().Values.size()); }
+    };
+
+    struct StandingEntry
+    {
+        ObjectGuid::LowType Guid;
+        uint32 ArenaTeamId;
+        uint32 Rating;
+        uint32 MMR;
+        uint32 SeasonGames;
+        uint32 SeasonWins;
+    };
+
+    class ArchiveWriter
+    {
+    public:
+        explicit ArchiveWriter(std::string const& path) : out(path, std::ios::out | std::ios::binary | std::ios::trunc) { }
+
+        bool IsOpen() const { return bool(out); }
+        uint64 GetOffset() { return uint64(out.tellp()); }
+
+        void WriteBytes(void const* data, size_t size) { out.write(static_cast<char const*>(data), size); }
+
+        template<typename T>
+        void WriteInt(T value)
+        {
+            uint8 bytes[sizeof(T)];
+            for (size_t i = 0; i < sizeof(T); i++)
+                bytes[i] = uint8(uint64(value) >> (8 * i));
+
+            WriteBytes(bytes, sizeof(T));
+        }
+
+        void WriteName(std::string const& name)
+        {
+            WriteInt<uint8>(uint8(name.size()));
+            WriteBytes(name.data(), uint8(name.size()));
+        }
+
+        void WriteMagic()
+        {
+            WriteBytes("SQ3ARCH", 7);
+            WriteInt<uint8>(SOLO_ARCHIVE_VERSION);
+        }
+
+    private:
+        std::ofstream out;
+    };
+
+    void AppendInt(std::vector<uint8>& payload, uint64 value, uint8 width)
+    {
+        for (uint8 i = 0; i < width; i++)
+            payload.push_back(uint8(value >> (8 * i)));
+    }
+
+    void AppendVarint(std::vector<uint8>& payload, uint64 value)
+    {
+        while (value >= 0x80)
+        {
+            payload.push_back(uint8(value) | 0x80);
+            value >>= 7;
+        }
+
+        payload.push_back(uint8(value));
+    }
+
+    void EncodeFrameOfReference(int64 const* values, uint32 rows, std::vector<uint8>& payload)
+    {
+        int64 base = *std::min_element(values, values + rows);
+        uint64 range = uint64(*std::max_element(values, values + rows) - base);
+        uint8 width = range <= 0xFF ? 1 : range <= 0xFFFF ? 2 : range <= 0xFFFFFFFF ? 4 : 8;
+
+        AppendInt(payload, uint64(base), 8);
+        payload.push_back(width);
+
+        for (uint32 i = 0; i < rows; i++)
+            AppendInt(payload, uint64(values[i] - base), width);
+    }
+
+    void EncodeDelta(int64 const* values, uint32 rows, std::vector<uint8>& payload)
+    {
+        AppendInt(payload, uint64(values[0]), 8);
+
+        for (uint32 i = 1; i < rows; i++)
+        {
+            int64 delta = values[i] - values[i - 1];
+            AppendVarint(payload, (uint64(delta) << 1) ^ uint64(delta >> 63)); // zigzag
+        }
+    }
+
+    // false when the block has more than 256 distinct values
+    bool EncodeDictionary(int64 const* values, uint32 rows, std::vector<uint8>& payload)
+    {
+        std::vector<int64> entries;
+        std::unordered_map<int64, uint8> indexes;
+
+        for (uint32 i = 0; i < rows; i++)
+        {
+            if (indexes.count(values[i]))
+                continue;
+
+            if (entries.size() == 256)
+                return false;
+
+            indexes[values[i]] = uint8(entries.size());
+            entries.push_back(values[i]);
+        }
+
+        AppendInt(payload, entries.size(), 2);
+        for (int64 entry : entries)
+            AppendInt(payload, uint64(entry), 8);
+
+        for (uint32 i = 0; i < rows; i++)
+            payload.push_back(indexes[values[i]]);
+
+        return true;
+    }
+
+    void WriteColumn(ArchiveWriter& writer, ArchiveColumn& column)
+    {
+        std::vector<uint8> candidates[3];
+
+        for (size_t start = 0; start < column.Values.size(); start += SOLO_ARCHIVE_BLOCK_ROWS)
+        {
+            int64 const* values = column.Values.data() + start;
+            uint32 rows = uint32(std::min<size_t>(SOLO_ARCHIVE_BLOCK_ROWS, column.Values.size() - start));
+
+            for (auto& candidate : candidates)
+                candidate.clear();
+
+            EncodeFrameOfReference(values, rows, candidates[SOLO_ARCHIVE_FOR]);
+            EncodeDelta(values, rows, candidates[SOLO_ARCHIVE_DELTA]);
+            bool dictionary = EncodeDictionary(values, rows, candidates[SOLO_ARCHIVE_DICT]);
+
+            uint8 encoding = SOLO_ARCHIVE_FOR;
+            if (candidates[SOLO_ARCHIVE_DELTA].size() < candidates[encoding].size())
+                encoding = SOLO_ARCHIVE_DELTA;
+
+            if (dictionary && candidates[SOLO_ARCHIVE_DICT].size() < candidates[encoding].size())
+                encoding = SOLO_ARCHIVE_DICT;
+
+            column.BlockOffsets.push_back(writer.GetOffset());
+            writer.WriteInt<uint8>(encoding);
+            writer.WriteInt<uint32>(rows);
+            writer.WriteInt<uint32>(uint32(candidates[encoding].size()));
+            writer.WriteBytes(candidates[encoding].data(), candidates[encoding].size());
+        }
+    }
+
+    void ReadSoloFights(ArchiveTable& matches, ArchiveTable& players, uint32 seasonStart)
+    {
+        // fight ids grow with time, the delta encoding profits from the order
+        QueryResult result = CharacterDatabase.Query("SELECT `fight_id`, UNIX_TIMESTAMP(`time`), `duration`, `winner`, `winner_mmr`, `winner_tr_change`, `loser_mmr`, `loser_tr_change` "
+            "FROM `log_arena_fights` WHERE `type` = {} AND `time` >= FROM_UNIXTIME({}) ORDER BY `fight_id`", ARENA_TYPE_3v3_SOLO, seasonStart);
+
+        if (!result)
+            return;
+
+        std::unordered_map<uint32, uint32> winners; // fight id -> winner arena team id
+        winners.reserve(result->GetRowCount());
+
+        do
+        {
+            Field* fields = result->Fetch();
+            uint32 fightId = fields[0].Get<uint32>();
+            winners[fightId] = fields[3].Get<uint32>();
+
+            matches.AddRow({ fightId, fields[1].Get<int64>(), fields[2].Get<uint32>(), fields[4].Get<int32>(), fields[5].Get<int32>(),
+                fields[6].Get<int32>(), fields[7].Get<int32>() });
+        } while (result->NextRow());
+
+        result = CharacterDatabase.Query("SELECT s.`fight_id`, s.`guid`, s.`team`, s.`damage`, s.`heal`, s.`kblows` FROM `log_arena_memberstats` s "
+            "JOIN `log_arena_fights` f ON f.`fight_id` = s.`fight_id` WHERE f.`type` = {} AND f.`time` >= FROM_UNIXTIME({}) ORDER BY s.`fight_id`, s.`member_id`",
+            ARENA_TYPE_3v3_SOLO, seasonStart);
+
+        if (!result)
+            return;
+
+        do
+        {
+            Field* fields = result->Fetch();
+            uint32 fightId = fields[0].Get<uint32>();
+            bool won = winners[fightId] == fields[2].Get<uint32>();
+
+            players.AddRow({ fightId, fields[1].Get<uint32>(), won, fields[3].Get<uint32>(), fields[4].Get<uint32>(), fields[5].Get<uint32>() });
+        } while (result->NextRow());
+    }
+
+    void WriteSolo3v3Archive(std::vector<StandingEntry>& standingEntries, std::string const& path, uint32 seasonStart)
+    {
+        uint32 oldMSTime = getMSTime();
+
+        ArchiveTable matches("matches", { "fight_id", "time", "duration", "winner_mmr", "winner_change", "loser_mmr", "loser_change" });
+        ArchiveTable players("match_players", { "fight_id", "guid", "won", "damage", "heal", "kills" });
+        ArchiveTable standings("standings", { "rank", "guid", "arena_team_id", "rating", "mmr", "season_games", "season_wins" });
+
+        ReadSoloFights(matches, players, seasonStart);
+
+        std::sort(standingEntries.begin(), standingEntries.end(), [](StandingEntry const& a, StandingEntry const& b)
+        {
+            return a.Rating != b.Rating ? a.Rating > b.Rating : a.Guid < b.Guid;
+        });
+
+        for (size_t i = 0; i < standingEntries.size(); i++)
+        {
+            StandingEntry const& entry = standingEntries[i];
+            standings.AddRow({ int64(i + 1), entry.Guid, entry.ArenaTeamId, entry.Rating, entry.MMR, entry.SeasonGames, entry.SeasonWins });
+        }
+
+        ArchiveWriter writer(path);
+        if (!writer.IsOpen())
+        {
+            LOG_ERROR("module", "Solo3v3: could not open {} for the season archive", path);
+            return;
+        }
+
+        writer.WriteMagic();
+
+        ArchiveTable* tables[] = { &matches, &players, &standings };
+        for (ArchiveTable* table : tables)
+            for (ArchiveColumn& column : table->Columns)
+                WriteColumn(writer, column);
+
+        uint64 footerOffset = writer.GetOffset();
+        writer.WriteInt<uint8>(uint8(std::size(tables)));
+
+        for (ArchiveTable* table : tables)
+        {
+            writer.WriteName(table->Name);
+            writer.WriteInt<uint32>(table->GetRows());
+            writer.WriteInt<uint8>(uint8(table->Columns.size()));
+
+            for (ArchiveColumn const& column : table->Columns)
+            {
+                writer.WriteName(column.Name);
+                writer.WriteInt<uint32>(uint32(column.BlockOffsets.size()));
+
+                for (uint64 offset : column.BlockOffsets)
+                    writer.WriteInt<uint64>(offset);
+            }
+        }
+
+        writer.WriteInt<uint64>(footerOffset);
+        writer.WriteMagic();
+
+        LOG_INFO("module", "Solo3v3: season archive {} written, {} matches, {} players, {} standings in {} ms", path,
+            matches.GetRows(), players.GetRows(), standings.GetRows(), GetMSTimeDiffToNow(oldMSTime));
+    }
+}
+
+void LoadSolo3v3SeasonStart()
+{
+    uint32 season = sWorld->getIntConfig(CONFIG_ARENA_SEASON_ID);
+    CharacterDatabase.DirectExecute(GetSolo3v3Statement(SOLO_INS_SEASON), season, uint32(GameTime::GetGameTime().count()));
+
+    QueryResult result = CharacterDatabase.Query(GetSolo3v3Statement(SOLO_SEL_SEASON_START), season);
+    SeasonStart = result ? result->Fetch()[0].Get<uint32>() : 0;
+
+    LOG_INFO("module", ">> Solo 3v3 arena season {} started at {}", season, SeasonStart.load());
+}
+
+bool ArchiveSolo3v3Season(std::string& fileName)
+{
+    std::lock_guard<std::mutex> lock(ArchiveWriterLock);
+
+    if (ArchiveWriterThread.joinable())
+    {
+        if (!ArchiveWriterDone->load())
+        {
+            LOG_ERROR("module", "Solo3v3: the previous season archive is still being written");
+            return false;
+        }
+
+        ArchiveWriterThread.join();
+    }
+
+    std::string directory = sConfigMgr->GetOption<std::string>("Solo.3v3.DumpDirectory", "");
+    if (!directory.empty() && directory.back() != '/' && directory.back() != '\\')
+        directory += '/';
+
+    // The arena teams live on the world thread, the standings are copied before handing off
+    auto standings = std::make_shared<std::vector<StandingEntry>>();
+
+    for (auto const& itr : sArenaTeamMgr->GetArenaTeams())
+    {
+        ArenaTeam* team = itr.second;
+        if (itr.first >= MAX_ARENA_TEAM_ID || team->GetType() != ARENA_TEAM_SOLO_3v3)
+            continue;
+
+        ArenaTeamMember* member = team->GetMember(team->GetCaptain());
+        ArenaTeamStats const& stats = team->GetStats();
+
+        standings->push_back({ team->GetCaptain().GetCounter(), team->GetId(), stats.Rating, member ? uint32(member->MatchMakerRating) : 0,
+            stats.SeasonGames, stats.SeasonWins });
+    }
+
+    fileName = directory + "soloq_season_" + std::to_string(sWorld->getIntConfig(CONFIG_ARENA_SEASON_ID)) + "_" +
+        std::to_string(GameTime::GetGameTime().count()) + ".sqa";
+
+    try
+    {
+        auto done = std::make_shared<std::atomic<bool>>(false);
+        ArchiveWriterThread = std::thread([standings, path = fileName, seasonStart = SeasonStart.load(), done]()
+        {
+            WriteSolo3v3Archive(*standings, path, seasonStart);
+            done->store(true);
+        });
+        ArchiveWriterDone = done;
+    }
+    catch (std::system_error const& e)
+    {
+        LOG_ERROR("module", "Solo3v3: could not start the season archive writer: {}", e.what());
+        return false;
+    }
+
+    return true;
+}
+
+void JoinSolo3v3ArchiveWriter()
+{
+    std::lock_guard<std::mutex> lock(ArchiveWriterLock);
+
+    if (ArchiveWriterThread.joinable())
+        ArchiveWriterThread.join();
+}
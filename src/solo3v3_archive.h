@@ -0,0 +1,66 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_ARCHIVE_H_
+#define _SOLO_3V3_ARCHIVE_H_
+
+#include "solo3v3.h"
+
+/*
+ * Season archive of the solo ladder, a columnar file for offline analysis (.soloq archive).
+ *
+ * Tables:
+ *   matches        fight_id, time, duration, winner_mmr, winner_change, loser_mmr, loser_change
+ *                  (solo fights of log_arena_fights since the season start in solo_3v3_season)
+ *   match_players  fight_id, guid, won, damage, heal, kills (log_arena_memberstats of those fights)
+ *   standings      rank, guid, arena_team_id, rating, mmr, season_games, season_wins
+ *
+ * Layout, all integers little endian:
+ *   "SQ3ARCH" + uint8 version
+ *   column blocks, each: uint8 encoding, uint32 rows, uint32 payload bytes, payload
+ *     SOLO_ARCHIVE_FOR    int64 base, uint8 width (1/2/4/8), rows * width bytes of value - base
+ *     SOLO_ARCHIVE_DELTA  int64 first value, rows - 1 zigzag varint deltas
+ *     SOLO_ARCHIVE_DICT   uint16 entries, entries * int64, rows * uint8 indexes
+ *   footer: uint8 tables, per table: name (uint8 length + bytes), uint32 rows, uint8 columns,
+ *           per column: name, uint32 blocks, per block: uint64 file offset
+ *   uint64 footer offset + "SQ3ARCH" + uint8 version
+ *
+ * A reader seeks to the footer and only reads the blocks of the columns it scans. Every block
+ * holds up to SOLO_ARCHIVE_BLOCK_ROWS rows and uses the smallest of the three encodings.
+ */
+enum Solo3v3ArchiveEncoding : uint8
+{
+    SOLO_ARCHIVE_FOR = 0,       // frame of reference, fixed width
+    SOLO_ARCHIVE_DELTA,
+    SOLO_ARCHIVE_DICT
+};
+
+constexpr uint32 SOLO_ARCHIVE_BLOCK_ROWS = 4096;
+constexpr uint8 SOLO_ARCHIVE_VERSION = 1;
+
+// Records the start of the current arena season in solo_3v3_season when it is new and loads it
+void LoadSolo3v3SeasonStart();
+
+// Snapshots the solo standings and writes the archive of the current season into fileName
+// (in Solo.3v3.DumpDirectory). The fights are read and the file written on a separate thread.
+// Returns false if an archive is still being written or no writer thread could be started.
+bool ArchiveSolo3v3Season(std::string& fileName);
+
+// Waits for the archive writer, called on shutdown while the character database is still open
+void JoinSolo3v3ArchiveWriter();
+
+#endif // _SOLO_3V3_ARCHIVE_H_
@@ -0,0 +1,107 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_db.h"
+#include "solo3v3_archive.h"
+#include "solo3v3_forecast.h"
+#include "solo3v3_invite.h"
+#include "solo3v3_leaver.h"
+#include "solo3v3_rating.h"
+#include "solo3v3_roles.h"
+#include "DatabaseEnv.h"
+#include "Log.h"
+#include "Timer.h"
+#include <future>
+#include <iterator>
+
+static char const* const Solo3v3Statements[MAX_SOLO_STATEMENTS] =
+{
+    // SOLO_SEL_LEAVERS
+    "SELECT `guid`, `score`, `last_update`, `lockout_until` FROM `solo_3v3_leaver` ORDER BY `guid`",
+    // SOLO_REP_LEAVER
+    "REPLACE INTO `solo_3v3_leaver` (`guid`, `score`, `last_update`, `lockout_until`) VALUES ({}, {}, {}, {})",
+    // SOLO_DEL_LEAVER
+    "DELETE FROM `solo_3v3_leaver` WHERE `guid` = {}",
+    // SOLO_INS_HISTORY
+    "INSERT INTO `solo_3v3_history` (`guid`, `time`, `instance_id`, `bracket`, `role`, `rating_change`, `mmr`) VALUES ({}, {}, {}, {}, {}, {}, {})",
+    // SOLO_SEL_FORECAST
+    "SELECT `hour`, `bracket`, `role`, `joins` FROM `solo_3v3_forecast`",
+    // SOLO_REP_FORECAST
+    "REPLACE INTO `solo_3v3_forecast` (`hour`, `bracket`, `role`, `joins`) VALUES ({}, {}, {}, {})",
+    // SOLO_SEL_INVITES
+    "SELECT `guid`, `invites`, `accepts` FROM `solo_3v3_invite` ORDER BY `guid`",
+    // SOLO_REP_INVITE
+    "REPLACE INTO `solo_3v3_invite` (`guid`, `invites`, `accepts`) VALUES ({}, {}, {})",
+    // SOLO_SEL_ROLE_REWARDS
+    "SELECT `guid`, `multiplier`, `time` FROM `solo_3v3_role_reward` WHERE `time` >= {}",
+    // SOLO_REP_ROLE_REWARD
+    "REPLACE INTO `solo_3v3_role_reward` (`guid`, `multiplier`, `time`) VALUES ({}, {}, {})",
+    // SOLO_DEL_ROLE_REWARDS
+    "DELETE FROM `solo_3v3_role_reward` WHERE `time` < {}",
+    // SOLO_INS_SEASON
+    "INSERT IGNORE INTO `solo_3v3_season` (`season_id`, `start_time`) SELECT {}, IF(COUNT(*) = 0, 0, {}) FROM `solo_3v3_season`",
+    // SOLO_SEL_SEASON_START
+    "SELECT `start_time` FROM `solo_3v3_season` WHERE `season_id` = {}"
+};
+
+char const* GetSolo3v3Statement(Solo3v3Statement statement)
+{
+    return Solo3v3Statements[statement];
+}
+
+void LoadSolo3v3StartupData()
+{
+    uint32 oldMSTime = getMSTime();
+
+    // Every load fills its own singleton and only reads the arena teams of the core,
+    // so they can run side by side while the world thread waits for them
+    struct StartupLoad
+    {
+        char const* Name;
+        void (*Load)();
+    };
+
+    static StartupLoad const loads[] =
+    {
+        { "solo_3v3_talent_role", []() { sSoloRoles->Load(); } },
+        { "solo_3v3_leaver",      []() { sSoloLeaver->LoadFromDB(); } },
+        { "solo ladder",          []() { sSoloRating->LoadLadder(); } },
+        { "solo_3v3_forecast",    []() { sSoloForecast->LoadFromDB(); } },
+        { "solo_3v3_invite",      []() { sSoloInvites->LoadFromDB(); } },
+        { "solo_3v3_role_reward", []() { sSolo->LoadRoleRewards(); } },
+        { "solo_3v3_season",      []() { LoadSolo3v3SeasonStart(); } }
+    };
+
+    std::vector<std::future<uint32>> results;
+    results.reserve(std::size(loads));
+
+    for (StartupLoad const& load : loads)
+    {
+        // falls back to running the load on get() when no thread can be started
+        results.push_back(std::async(std::launch::async | std::launch::deferred, [&load]()
+        {
+            uint32 startMSTime = getMSTime();
+            load.Load();
+            return GetMSTimeDiffToNow(startMSTime);
+        }));
+    }
+
+    for (size_t i = 0; i < results.size(); i++)
+        LOG_INFO("module", ">> Solo 3v3 startup load of {} took {} ms", loads[i].Name, results[i].get());
+
+    LOG_INFO("module", ">> Loaded the solo 3v3 data in {} ms", GetMSTimeDiffToNow(oldMSTime));
+}
@@ -0,0 +1,51 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_DB_H_
+#define _SOLO_3V3_DB_H_
+
+#include "solo3v3.h"
+#include "DatabaseEnvFwd.h"
+
+// Character database statements of the solo_3v3_* tables. Writes and deletes go by primary key or index,
+// the startup loads read their tables whole. The season archive queries the core's arena logs itself.
+enum Solo3v3Statement : uint8
+{
+    SOLO_SEL_LEAVERS,           // full load on startup
+    SOLO_REP_LEAVER,            // guid, score, last_update, lockout_until
+    SOLO_DEL_LEAVER,            // guid
+    SOLO_INS_HISTORY,           // guid, time, instance_id, bracket, role, rating_change, mmr
+    SOLO_SEL_FORECAST,          // full load on startup
+    SOLO_REP_FORECAST,          // hour, bracket, role, joins
+    SOLO_SEL_INVITES,           // full load on startup
+    SOLO_REP_INVITE,            // guid, invites, accepts
+    SOLO_SEL_ROLE_REWARDS,      // time, startup load of the past week
+    SOLO_REP_ROLE_REWARD,       // guid, multiplier, time
+    SOLO_DEL_ROLE_REWARDS,      // time, rows older than that
+    SOLO_INS_SEASON,            // season_id, start_time; the first season seen starts at 0
+    SOLO_SEL_SEASON_START,      // season_id
+    MAX_SOLO_STATEMENTS
+};
+
+// SQL of a statement, the {} placeholders only ever take numbers
+char const* GetSolo3v3Statement(Solo3v3Statement statement);
+
+// Runs the startup loads of the module (talent roles, leavers, ladder, forecast, invites, role rewards, season start) in parallel and
+// returns once all of them are published. Called from OnStartup, before the world accepts logins.
+void LoadSolo3v3StartupData();
+
+#endif // _SOLO_3V3_DB_H_
@@ -0,0 +1,247 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_dump.h"
+#include "solo3v3_rating.h"
+#include "Config.h"
+#include "GameTime.h"
+#include "Log.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+// Writer threads still running or not joined yet, joined on shutdown by JoinSolo3v3DumpWriters
+struct Solo3v3DumpWriter
+{
+    std::thread Thread;
+    std::shared_ptr<std::atomic<bool>> Done;
+};
+
+static std::mutex DumpWritersLock;
+static std::vector<Solo3v3DumpWriter> DumpWriters;
+static uint32 DumpSequence = 0;
+
+static void TakeSolo3v3Snapshot(Solo3v3DumpSnapshot& snapshot)
+{
+    snapshot.Time = uint32(GameTime::GetGameTime().count());
+    snapshot.Config = sSolo->GetConfig();
+    snapshot.MatchWindow.Enable = sSoloRating->IsEnabled();
+    snapshot.MatchWindow.Nearest = sSoloRating->GetNearest();
+    snapshot.MatchWindow.LadderPercent = sSoloRating->GetLadderPercent();
+    snapshot.MatchWindow.MinWindow = sSoloRating->GetMinWindow();
+    snapshot.MatchWindow.MaxWindow = sSoloRating->GetMaxWindow();
+    snapshot.MatchWindow.Anchors = sSoloRating->GetAnchors();
+    snapshot.MatchWindow.WidenPerMinute = sSoloRating->GetWidenPerMinute();
+
+    uint32 now = GameTime::GetGameTimeMS().count();
+    BattlegroundQueue& queue = sBattlegroundMgr->GetBattlegroundQueue(bgQueueTypeId);
+
+    for (int bracket = BG_BRACKET_ID_FIRST; bracket <= BG_BRACKET_ID_LAST; bracket++)
+    {
+        for (int teamId = 0; teamId < BG_TEAMS_COUNT; teamId++)
+        {
+            for (auto const& ginfo : queue.m_QueuedGroups[bracket][teamId])
+            {
+                if (ginfo->ArenaType != ARENA_TYPE_3v3_SOLO)
+                    continue;
+
+                Solo3v3DumpEntry entry;
+                entry.MMR = ginfo->ArenaMatchmakerRating;
+                entry.WaitTime = getMSTimeDiff(ginfo->JoinTime, now);
+                entry.InvitedInstance = ginfo->IsInvitedToBGInstanceGUID;
+                entry.BracketId = uint8(bracket);
+                entry.TeamId = uint8(teamId);
+                entry.GroupSize = 0;
+
+                for (auto const& playerGuid : ginfo->Players)
+                {
+                    if (entry.GroupSize >= 2)
+                        break; // Should never happen, groups are a solo or a duo
+
+                    entry.Guids[entry.GroupSize] = playerGuid.GetCounter();
+                    entry.Roles[entry.GroupSize] = MAX_TALENT_CAT;
+                    if (Player* plr = ObjectAccessor::FindPlayer(playerGuid))
+                        entry.Roles[entry.GroupSize] = sSolo->GetCachedTalentCatForSolo3v3(plr);
+
+                    entry.GroupSize++;
+                }
+
+                snapshot.Entries.push_back(entry);
+            }
+        }
+    }
+
+    snapshot.Arenas.reserve(sSolo->GetArenaInfos().size());
+    for (auto const& itr : sSolo->GetArenaInfos())
+        snapshot.Arenas.push_back(itr.second);
+
+    for (auto const& itr : sArenaTeamMgr->GetArenaTeams())
+        if (itr.first >= MAX_ARENA_TEAM_ID && itr.second->GetType() == ARENA_TEAM_SOLO_3v3)
+            snapshot.TempArenaTeams++;
+}
+
+static void WriteSolo3v3Snapshot(Solo3v3DumpSnapshot const& snapshot, std::string const& path)
+{
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out)
+    {
+        LOG_ERROR("module", "Solo3v3: could not open {} for the solo queue dump", path);
+        return;
+    }
+
+    Solo3v3Config const& config = snapshot.Config;
+    Solo3v3DumpMatchWindow const& window = snapshot.MatchWindow;
+
+    out << std::boolalpha;
+    out << "{\n";
+    out << "  \"time\": " << snapshot.Time << ",\n";
+    out << "  \"config\": { \"enable\": " << config.Enable << ", \"filterTalents\": " << config.FilterTalents
+        << ", \"validateMatches\": " << config.ValidateMatches << ", \"castDeserterOnAfk\": " << config.CastDeserterOnAfk
+        << ", \"stopGameIncomplete\": " << config.StopGameIncomplete << ", \"cost\": " << config.Cost
+        << ", \"allowDuoQueue\": " << config.AllowDuoQueue << ", \"backfillEnable\": " << config.BackfillEnable
+        << ", \"backfillMaxMMRDifference\": " << config.BackfillMaxMMRDifference << ", \"backfillMinTimeLeft\": " << config.BackfillMinTimeLeft
+        << ", \"roleBonusEnable\": " << config.RoleBonusEnable << ", \"roleBonusFactor\": " << config.RoleBonusFactor
+        << ", \"roleBonusMax\": " << config.RoleBonusMax << ", \"roleBonusInterval\": " << config.RoleBonusInterval
+        << ", \"matchWindow\": { \"enable\": " << window.Enable << ", \"nearest\": " << window.Nearest
+        << ", \"ladderPercent\": " << window.LadderPercent << ", \"min\": " << window.MinWindow << ", \"max\": " << window.MaxWindow
+        << ", \"anchors\": " << window.Anchors << ", \"widenPerMinute\": " << window.WidenPerMinute << " } },\n";
+    out << "  \"tempArenaTeams\": " << snapshot.TempArenaTeams << ",\n";
+
+    // queued and reserved entries, grouped by bracket
+    for (int reserved = 0; reserved < 2; reserved++)
+    {
+        out << (reserved ? "  \"reserved\": [" : "  \"queued\": [");
+
+        bool first = true;
+        for (auto const& entry : snapshot.Entries)
+        {
+            if (bool(entry.InvitedInstance) != bool(reserved))
+                continue;
+
+            out << (first ? "\n" : ",\n");
+            first = false;
+
+            out << "    { \"bracket\": " << uint32(entry.BracketId) << ", \"team\": " << uint32(entry.TeamId) << ", \"players\": [";
+
+            for (uint8 member = 0; member < entry.GroupSize; member++)
+            {
+                out << (member ? ", " : "") << "{ \"guid\": " << entry.Guids[member] << ", \"role\": ";
+
+                if (entry.Roles[member] < MAX_TALENT_CAT)
+                    out << uint32(entry.Roles[member]);
+                else
+                    out << "null";
+
+                out << " }";
+            }
+
+            out << "], \"mmr\": " << entry.MMR << ", \"waitMs\": " << entry.WaitTime << ", \"groupSize\": " << uint32(entry.GroupSize);
+
+            if (reserved)
+                out << ", \"instance\": " << entry.InvitedInstance;
+
+            out << " }";
+        }
+
+        out << (first ? "],\n" : "\n  ],\n");
+    }
+
+    out << "  \"arenas\": [";
+    for (size_t i = 0; i < snapshot.Arenas.size(); i++)
+    {
+        Solo3v3ArenaInfo const& info = snapshot.Arenas[i];
+
+        out << (i ? ",\n" : "\n");
+        out << "    { \"instance\": " << info.InstanceId << ", \"bracket\": " << uint32(info.BracketId)
+            << ", \"ageMs\": " << getMSTimeDiff(info.CreateTime, GameTime::GetGameTimeMS().count()) << ", \"teams\": [";
+
+        for (uint32 team = 0; team < BG_TEAMS_COUNT; team++)
+        {
+            out << (team ? ", " : "") << "{ \"arenaTeamId\": " << info.ArenaTeamIds[team] << ", \"mmr\": " << info.TeamMMR[team] << ", \"players\": [";
+
+            for (uint32 slot = 0; slot < info.PlayerCount[team]; slot++)
+            {
+                out << (slot ? ", " : "") << "{ \"guid\": " << info.Players[team][slot].GetCounter() << ", \"role\": " << uint32(info.Roles[team][slot])
+                    << ", \"mmr\": " << info.PlayerMMR[team][slot] << " }";
+            }
+
+            out << "] }";
+        }
+
+        out << "] }";
+    }
+
+    out << (snapshot.Arenas.empty() ? "]\n" : "\n  ]\n");
+    out << "}\n";
+}
+
+bool DumpSolo3v3State(std::string& fileName)
+{
+    std::string directory = sConfigMgr->GetOption<std::string>("Solo.3v3.DumpDirectory", "");
+    if (!directory.empty() && directory.back() != '/' && directory.back() != '\\')
+        directory += '/';
+
+    // Copying is a flat struct per entry; the JSON formatting and the file IO run on the writer thread
+    auto snapshot = std::make_shared<Solo3v3DumpSnapshot>();
+    TakeSolo3v3Snapshot(*snapshot);
+
+    // the sequence keeps two dumps of the same second apart
+    fileName = directory + "soloq_dump_" + std::to_string(snapshot->Time) + "_" + std::to_string(++DumpSequence) + ".json";
+
+    std::lock_guard<std::mutex> lock(DumpWritersLock);
+
+    // Finished writers are joined here, so the list only holds the ones still writing
+    DumpWriters.erase(std::remove_if(DumpWriters.begin(), DumpWriters.end(), [](Solo3v3DumpWriter& writer)
+    {
+        if (!writer.Done->load(std::memory_order_acquire))
+            return false;
+
+        writer.Thread.join();
+        return true;
+    }), DumpWriters.end());
+
+    try
+    {
+        auto done = std::make_shared<std::atomic<bool>>(false);
+        std::thread thread([snapshot, done, path = fileName]()
+        {
+            WriteSolo3v3Snapshot(*snapshot, path);
+            done->store(true, std::memory_order_release);
+        });
+
+        DumpWriters.push_back({ std::move(thread), done });
+    }
+    catch (std::system_error const& e)
+    {
+        LOG_ERROR("module", "Solo3v3: could not start the dump writer: {}", e.what());
+        return false;
+    }
+
+    return true;
+}
+
+void JoinSolo3v3DumpWriters()
+{
+    std::lock_guard<std::mutex> lock(DumpWritersLock);
+
+    for (Solo3v3DumpWriter& writer : DumpWriters)
+        writer.Thread.join();
+
+    DumpWriters.clear();
+}
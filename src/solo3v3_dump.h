@@ -0,0 +1,65 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_DUMP_H_
+#define _SOLO_3V3_DUMP_H_
+
+#include "solo3v3.h"
+
+// One queued group, copied out of the battleground queue
+struct Solo3v3DumpEntry
+{
+    ObjectGuid::LowType Guids[2];
+    uint32 MMR;
+    uint32 WaitTime;            // ms
+    uint32 InvitedInstance;     // != 0 for entries reserved for an arena
+    uint8 BracketId;
+    uint8 TeamId;
+    uint8 Roles[2];             // MAX_TALENT_CAT when the player is offline
+    uint8 GroupSize;            // members in Guids and Roles, 2 for a duo
+};
+
+// Solo3v3RatingDistribution settings of the MMR windows
+struct Solo3v3DumpMatchWindow
+{
+    bool Enable = false;
+    uint32 Nearest = 0;
+    float LadderPercent = 0.0f;
+    uint32 MinWindow = 0;
+    uint32 MaxWindow = 0;
+    uint32 Anchors = 0;
+    uint32 WidenPerMinute = 0;
+};
+
+// Copy of the solo state taken on the world thread. Serialized to JSON on a separate thread.
+struct Solo3v3DumpSnapshot
+{
+    uint32 Time = 0;
+    Solo3v3Config Config;
+    Solo3v3DumpMatchWindow MatchWindow;
+    std::vector<Solo3v3DumpEntry> Entries;
+    std::vector<Solo3v3ArenaInfo> Arenas;
+    uint32 TempArenaTeams = 0;
+};
+
+// Snapshots the solo queue and arenas and writes them as JSON into fileName (in Solo.3v3.DumpDirectory).
+// Returns false if no writer thread could be started.
+bool DumpSolo3v3State(std::string& fileName);
+// Waits for the writer threads still running, on shutdown before the logs go away
+void JoinSolo3v3DumpWriters();
+
+#endif // _SOLO_3V3_DUMP_H_
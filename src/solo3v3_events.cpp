@@ -0,0 +1,225 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_events.h"
+#include "solo3v3_memory.h"
+#include "Config.h"
+#include "GameTime.h"
+#include "Log.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+static char const* const EventTypeNames[MAX_SOLO_EVENTS] =
+{
+    "join",
+    "leave",
+    "match",
+    "desert",
+    "abort",
+    "rating"
+};
+
+Solo3v3EventLog* Solo3v3EventLog::instance()
+{
+    static Solo3v3EventLog instance;
+    return &instance;
+}
+
+void Solo3v3EventLog::LoadConfig()
+{
+    enabled.store(sConfigMgr->GetOption<bool>("Solo.3v3.EventLog.Enable", false), std::memory_order_relaxed);
+    maxSize.store(uint64(std::max<uint32>(1, sConfigMgr->GetOption<uint32>("Solo.3v3.EventLog.MaxSize", 64))) * 1024 * 1024, std::memory_order_relaxed);
+
+    // The writer thread reads the rest, they only change while it is stopped
+    if (running)
+        return;
+
+    path = sConfigMgr->GetOption<std::string>("Solo.3v3.EventLog.File", "soloq_events.log");
+
+    capacity = 256;
+    while (capacity < sConfigMgr->GetOption<uint32>("Solo.3v3.EventLog.BufferSize", 8192))
+        capacity <<= 1;
+
+    if (startupDone)
+        Start();
+}
+
+void Solo3v3EventLog::Start()
+{
+    startupDone = true;
+
+    if (!enabled.load(std::memory_order_relaxed) || running)
+        return;
+
+    ring = std::make_unique<Slot[]>(capacity);
+    mask = capacity - 1;
+
+    for (size_t i = 0; i < capacity; i++)
+        ring[i].Sequence.store(i, std::memory_order_relaxed);
+
+    head.store(0, std::memory_order_relaxed);
+    tail = 0;
+    dropped.store(0, std::memory_order_relaxed);
+    stopRequested.store(false, std::memory_order_relaxed);
+
+    try
+    {
+        writer = std::thread(&Solo3v3EventLog::WriterLoop, this);
+    }
+    catch (std::system_error const& e)
+    {
+        LOG_ERROR("module", "Solo3v3: could not start the event log writer: {}", e.what());
+        return;
+    }
+
+    running.store(true, std::memory_order_release);
+    LOG_INFO("module", ">> Solo 3v3 event log written to {}", path);
+}
+
+void Solo3v3EventLog::Stop()
+{
+    if (!running)
+        return;
+
+    // The ring stays allocated, a producer that saw running a moment ago may still write into it
+    running.store(false, std::memory_order_release);
+    stopRequested.store(true, std::memory_order_release);
+    writer.join();
+}
+
+void Solo3v3EventLog::Push(Solo3v3EventType type, ObjectGuid::LowType guid, uint8 bracket, uint32 instance, uint32 mmr, int32 delta, uint8 team, uint8 role)
+{
+    size_t pos = head.load(std::memory_order_relaxed);
+    Slot* slot;
+
+    for (;;)
+    {
+        slot = &ring[pos & mask];
+        size_t sequence = slot->Sequence.load(std::memory_order_acquire);
+        intptr_t diff = intptr_t(sequence) - intptr_t(pos);
+
+        if (!diff)
+        {
+            if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            // full, the writer is a whole ring behind
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else
+            pos = head.load(std::memory_order_relaxed);
+    }
+
+    Solo3v3EventRecord& record = slot->Record;
+    record.Time = uint32(GameTime::GetGameTime().count());
+    record.Guid = guid;
+    record.Instance = instance;
+    record.MMR = mmr;
+    record.Delta = delta;
+    record.Type = type;
+    record.Bracket = bracket;
+    record.Team = team;
+    record.Role = role;
+
+    slot->Sequence.store(pos + 1, std::memory_order_release);
+}
+
+bool Solo3v3EventLog::Pop(Solo3v3EventRecord& record)
+{
+    Slot& slot = ring[tail & mask];
+    if (slot.Sequence.load(std::memory_order_acquire) != tail + 1)
+        return false;
+
+    record = slot.Record;
+    slot.Sequence.store(tail + capacity, std::memory_order_release);
+    tail++;
+    return true;
+}
+
+void Solo3v3EventLog::WriterLoop()
+{
+    std::ofstream out(path, std::ios::out | std::ios::app);
+    if (!out)
+        LOG_ERROR("module", "Solo3v3: could not open {} for the event log, events are discarded", path);
+
+    uint64 size = out ? uint64(out.tellp()) : 0;
+    uint32 reportedDropped = 0;
+
+    for (;;)
+    {
+        bool stopping = stopRequested.load(std::memory_order_acquire);
+        bool wrote = false;
+
+        Solo3v3EventRecord record;
+        while (Pop(record))
+        {
+            if (!out)
+                continue;
+
+            char line[256];
+            int length = snprintf(line, sizeof(line), "{\"time\":%u,\"type\":\"%s\",\"guid\":%u,\"bracket\":%u,\"instance\":%u,\"team\":%u,\"role\":%u,\"mmr\":%u,\"delta\":%d}\n",
+                record.Time, record.Type < MAX_SOLO_EVENTS ? EventTypeNames[record.Type] : "?", record.Guid, uint32(record.Bracket), record.Instance,
+                uint32(record.Team), uint32(record.Role), record.MMR, record.Delta);
+
+            out.write(line, length);
+            size += length;
+            wrote = true;
+        }
+
+        uint32 droppedNow = dropped.load(std::memory_order_relaxed);
+        if (out && droppedNow != reportedDropped)
+        {
+            char line[96];
+            int length = snprintf(line, sizeof(line), "{\"time\":%u,\"type\":\"dropped\",\"count\":%u}\n", uint32(GameTime::GetGameTime().count()), droppedNow - reportedDropped);
+            out.write(line, length);
+            size += length;
+            reportedDropped = droppedNow;
+            wrote = true;
+        }
+
+        if (wrote)
+            out.flush();
+
+        if (out && size >= maxSize.load(std::memory_order_relaxed))
+        {
+            out.close();
+
+            std::string rotated = path + ".1";
+            std::remove(rotated.c_str());
+            std::rename(path.c_str(), rotated.c_str());
+
+            out.open(path, std::ios::out | std::ios::trunc);
+            size = 0;
+        }
+
+        if (stopping)
+            break;
+
+        if (!wrote)
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+}
+
+void Solo3v3EventLog::ReportMemory(Solo3v3MemoryReport& report) const
+{
+    size_t slots = ring ? capacity : 0;
+    report.Add("event log ring", slots * sizeof(Slot), slots);
+}
@@ -0,0 +1,109 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_EVENTS_H_
+#define _SOLO_3V3_EVENTS_H_
+
+#include "solo3v3.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+
+enum Solo3v3EventType : uint8
+{
+    SOLO_EVENT_JOIN = 0,        // mmr = queue rating
+    SOLO_EVENT_LEAVE,           // left the queue
+    SOLO_EVENT_MATCH,           // one record per player of a formed arena, team/role/mmr of the slot
+    SOLO_EVENT_DESERT,          // left a running solo arena
+    SOLO_EVENT_ABORT,           // arena ended incomplete, guid = 0
+    SOLO_EVENT_RATING,          // mmr = new rating, delta = change
+    MAX_SOLO_EVENTS
+};
+
+// Flat record copied into the ring by the logging thread, formatted by the writer thread
+struct Solo3v3EventRecord
+{
+    uint32 Time;                // unix time
+    ObjectGuid::LowType Guid;
+    uint32 Instance;
+    uint32 MMR;
+    int32 Delta;
+    uint8 Type;
+    uint8 Bracket;
+    uint8 Team;
+    uint8 Role;
+};
+
+/*
+ * Structured log of solo queue activity, one JSON object per line in Solo.3v3.EventLog.File.
+ *
+ * Log() only copies a record into a bounded lock-free ring (several producers, rating changes are
+ * logged from map threads), a writer thread drains it, formats the lines and rotates the file at
+ * Solo.3v3.EventLog.MaxSize. When the ring is full the record is dropped and counted, the writer
+ * reports the count with a "dropped" line. Nothing ever blocks the logging thread. The writer
+ * runs until shutdown once started, Solo.3v3.EventLog.Enable can be toggled by a config reload.
+ */
+class Solo3v3EventLog
+{
+public:
+    static Solo3v3EventLog* instance();
+
+    void LoadConfig();
+    void Start();
+    // Drains what is left and joins the writer thread
+    void Stop();
+    void ReportMemory(Solo3v3MemoryReport& report) const;
+
+    void Log(Solo3v3EventType type, ObjectGuid::LowType guid, uint8 bracket = 0, uint32 instance = 0, uint32 mmr = 0, int32 delta = 0, uint8 team = 0, uint8 role = 0)
+    {
+        if (enabled.load(std::memory_order_relaxed) && running.load(std::memory_order_relaxed))
+            Push(type, guid, bracket, instance, mmr, delta, team, role);
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> Sequence;
+        Solo3v3EventRecord Record;
+    };
+
+    void Push(Solo3v3EventType type, ObjectGuid::LowType guid, uint8 bracket, uint32 instance, uint32 mmr, int32 delta, uint8 team, uint8 role);
+    bool Pop(Solo3v3EventRecord& record);
+    void WriterLoop();
+
+    // Reloaded while the writer thread runs, disabling only stops Log() from recording
+    std::atomic<bool> enabled{ false };
+    bool startupDone = false;                      // Start() ran, a reload that enables the log starts the writer
+    std::atomic<uint64> maxSize{ 64 * 1024 * 1024 };
+
+    std::string path;
+    size_t capacity = 8192;
+
+    std::unique_ptr<Slot[]> ring;
+    size_t mask = 0;
+    alignas(64) std::atomic<size_t> head{ 0 };     // next position to write, shared by the producers
+    alignas(64) size_t tail = 0;                   // next position to read, writer thread only
+    alignas(64) std::atomic<uint32> dropped{ 0 };
+
+    std::atomic<bool> running{ false };
+    std::atomic<bool> stopRequested{ false };
+    std::thread writer;
+};
+
+#define sSoloEvents Solo3v3EventLog::instance()
+
+#endif // _SOLO_3V3_EVENTS_H_
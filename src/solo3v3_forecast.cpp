@@ -0,0 +1,221 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_forecast.h"
+#include "solo3v3_db.h"
+#include "solo3v3_memory.h"
+#include "Chat.h"
+#include "Config.h"
+#include "DatabaseEnv.h"
+#include "GameTime.h"
+#include "Log.h"
+#include "Timer.h"
+#include <algorithm>
+#include <cmath>
+
+// Matches need six joins
+constexpr float SOLO_FORECAST_PLAYERS_PER_MATCH = 6.0f;
+
+Solo3v3Forecast* Solo3v3Forecast::instance()
+{
+    static Solo3v3Forecast instance;
+    return &instance;
+}
+
+void Solo3v3Forecast::LoadConfig()
+{
+    enabled = sConfigMgr->GetOption<bool>("Solo.3v3.Forecast.Enable", false);
+    smoothing = std::clamp(sConfigMgr->GetOption<float>("Solo.3v3.Forecast.Smoothing", 0.3f), 0.01f, 1.0f);
+    busyJoins = std::max(1.0f, sConfigMgr->GetOption<float>("Solo.3v3.Forecast.BusyJoins", 30.0f));
+}
+
+void Solo3v3Forecast::LoadFromDB()
+{
+    uint32 oldMSTime = getMSTime();
+    uint32 count = 0;
+
+    QueryResult result = CharacterDatabase.Query(GetSolo3v3Statement(SOLO_SEL_FORECAST));
+    if (!result)
+        return;
+
+    do
+    {
+        Field* fields = result->Fetch();
+        uint32 hour = fields[0].Get<uint16>();
+        uint32 bracket = fields[1].Get<uint8>();
+        uint32 role = fields[2].Get<uint8>();
+
+        if (hour >= SOLO_FORECAST_HOURS || bracket >= MAX_BATTLEGROUND_BRACKETS || role >= MAX_TALENT_CAT)
+        {
+            LOG_ERROR("sql.sql", "Table `solo_3v3_forecast` has invalid hour {}, bracket {} or role {}, skipped.", hour, bracket, role);
+            continue;
+        }
+
+        averages[hour][bracket][role] = fields[3].Get<float>();
+        knownHours.set(hour);
+        count++;
+    } while (result->NextRow());
+
+    LOG_INFO("module", ">> Loaded {} solo 3v3 forecast slots ({} of {} hours known) in {} ms", count, knownHours.count(), SOLO_FORECAST_HOURS, GetMSTimeDiffToNow(oldMSTime));
+}
+
+void Solo3v3Forecast::OnJoin(BattlegroundBracketId bracket_id, Solo3v3TalentCat role)
+{
+    if (enabled)
+        counts[bracket_id][role]++;
+}
+
+void Solo3v3Forecast::Update(uint32 diff)
+{
+    if (!enabled)
+        return;
+
+    uint32 now = GameTime::GetGameTime().count();
+    uint32 hour = GetHourOfWeek(now);
+
+    if (hour != countedHour)
+    {
+        if (countedHour != SOLO_FORECAST_HOURS)
+            CloseHour();
+
+        // A skipped hour (server down) leaves its slot as it was
+        countedHourComplete = countedHour != SOLO_FORECAST_HOURS && (countedHour + 1) % SOLO_FORECAST_HOURS == hour;
+        countedHour = hour;
+        predictTimer = MINUTE * IN_MILLISECONDS;
+    }
+
+    predictTimer += diff;
+    if (predictTimer < MINUTE * IN_MILLISECONDS)
+        return;
+
+    predictTimer = 0;
+    Predict(now);
+}
+
+void Solo3v3Forecast::CloseHour()
+{
+    if (countedHourComplete)
+    {
+        bool known = knownHours.test(countedHour);
+        CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
+
+        for (uint32 bracket = 0; bracket < MAX_BATTLEGROUND_BRACKETS; bracket++)
+        {
+            for (uint32 role = 0; role < MAX_TALENT_CAT; role++)
+            {
+                float& average = averages[countedHour][bracket][role];
+                average = known ? average + smoothing * (float(counts[bracket][role]) - average) : float(counts[bracket][role]);
+
+                // Zeros too, a quiet hour is known after a restart
+                trans->Append(GetSolo3v3Statement(SOLO_REP_FORECAST), countedHour, bracket, role, average);
+            }
+        }
+
+        knownHours.set(countedHour);
+        CharacterDatabase.CommitTransaction(trans);
+    }
+
+    memset(counts, 0, sizeof(counts));
+}
+
+void Solo3v3Forecast::Predict(uint32 now)
+{
+    memset(predicted, 0, sizeof(predicted));
+    predictionReady = true;
+
+    // The horizon overlaps at most two hours, each contributes the share of its hour it covers
+    for (uint32 start = now, end = now + SOLO_FORECAST_HORIZON; start < end;)
+    {
+        uint32 hourEnd = (start / HOUR + 1) * HOUR;
+        uint32 covered = std::min(hourEnd, end) - start;
+        uint32 hour = GetHourOfWeek(start);
+
+        predictionReady = predictionReady && knownHours.test(hour);
+
+        for (uint32 bracket = 0; bracket < MAX_BATTLEGROUND_BRACKETS; bracket++)
+            for (uint32 role = 0; role < MAX_TALENT_CAT; role++)
+                predicted[bracket][role] += averages[hour][bracket][role] * covered / HOUR;
+
+        start += covered;
+    }
+
+    if (!predictionReady)
+        return;
+
+    float joins = 0.0f;
+    for (uint32 bracket = 0; bracket < MAX_BATTLEGROUND_BRACKETS; bracket++)
+        joins += GetPredictedJoins(BattlegroundBracketId(bracket));
+
+    // The core creates the arena instances itself when a match pops, the module can only get its own
+    // containers ready for them
+    sSolo->ReserveCapacity(uint32(std::ceil(joins / SOLO_FORECAST_PLAYERS_PER_MATCH)), uint32(std::ceil(joins)));
+}
+
+float Solo3v3Forecast::GetPredictedJoins(BattlegroundBracketId bracket_id) const
+{
+    float joins = 0.0f;
+    for (uint32 role = 0; role < MAX_TALENT_CAT; role++)
+        joins += predicted[bracket_id][role];
+
+    return joins;
+}
+
+uint32 Solo3v3Forecast::GetWindowFloor(BattlegroundBracketId bracket_id, uint32 minWindow, uint32 maxWindow) const
+{
+    if (!enabled || !predictionReady)
+        return minWindow;
+
+    float joins = GetPredictedJoins(bracket_id);
+    if (joins >= busyJoins)
+        return minWindow;
+
+    // Half the arrivals need twice the MMR range to find as many opponents
+    float scale = busyJoins / std::max(joins, 1.0f);
+    return uint32(std::min(minWindow * scale, float(maxWindow)));
+}
+
+void Solo3v3Forecast::Print(ChatHandler* handler) const
+{
+    if (!enabled)
+    {
+        handler->SendSysMessage("The solo queue forecast is disabled (Solo.3v3.Forecast.Enable).");
+        return;
+    }
+
+    handler->PSendSysMessage("Solo queue forecast, %u of %u hours of the week known.", uint32(knownHours.count()), SOLO_FORECAST_HOURS);
+
+    if (!predictionReady)
+    {
+        handler->SendSysMessage("No history for the next 15 minutes yet.");
+        return;
+    }
+
+    for (uint32 bracket = 0; bracket < MAX_BATTLEGROUND_BRACKETS; bracket++)
+    {
+        float joins = GetPredictedJoins(BattlegroundBracketId(bracket));
+        if (joins < 0.05f)
+            continue;
+
+        handler->PSendSysMessage("Bracket %u: %.1f joins in the next 15 minutes (melee %.1f, range %.1f, healer %.1f), %.1f matches",
+            bracket, joins, predicted[bracket][MELEE], predicted[bracket][RANGE], predicted[bracket][HEALER], joins / SOLO_FORECAST_PLAYERS_PER_MATCH);
+    }
+}
+
+void Solo3v3Forecast::ReportMemory(Solo3v3MemoryReport& report) const
+{
+    report.Add("forecast table", sizeof(averages) + sizeof(knownHours), SOLO_FORECAST_HOURS);
+}
@@ -0,0 +1,87 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_FORECAST_H_
+#define _SOLO_3V3_FORECAST_H_
+
+#include "solo3v3.h"
+#include <bitset>
+
+class ChatHandler;
+
+constexpr uint32 SOLO_FORECAST_HOURS = 7 * 24;         // slot 0 is Thursday 00:00 UTC, the weekday of the unix epoch
+constexpr uint32 SOLO_FORECAST_HORIZON = 15 * MINUTE;
+
+/*
+ * Expected solo queue joins per hour of the week, bracket and role.
+ *
+ * Joins are counted for the running hour. When the hour is over its count is folded into the slot of
+ * that hour of the week as a moving average (Solo.3v3.Forecast.Smoothing is the weight of the new
+ * week) and the slot is written to solo_3v3_forecast, so the history survives restarts. The table
+ * wraps every week. The hour the server started in is incomplete and not folded.
+ *
+ * Every minute the next 15 minutes are predicted from the slots they overlap. A quiet bracket starts
+ * with a wider MMR window (GetWindowFloor) and the module containers are reserved ahead of the
+ * matches expected, so a peak does not rehash them while the matcher runs.
+ */
+class Solo3v3Forecast
+{
+public:
+    static Solo3v3Forecast* instance();
+
+    void LoadConfig();
+    void LoadFromDB();
+    void Update(uint32 diff);
+    void ReportMemory(Solo3v3MemoryReport& report) const;
+    void Print(ChatHandler* handler) const;
+
+    bool IsEnabled() const { return enabled; }
+
+    void OnJoin(BattlegroundBracketId bracket_id, Solo3v3TalentCat role);
+
+    // Joins expected in the next 15 minutes, only meaningful while HasPrediction()
+    bool HasPrediction() const { return predictionReady; }
+    float GetPredictedJoins(BattlegroundBracketId bracket_id, Solo3v3TalentCat role) const { return predicted[bracket_id][role]; }
+    float GetPredictedJoins(BattlegroundBracketId bracket_id) const;
+
+    // minWindow while Solo.3v3.Forecast.BusyJoins or more joins are expected, wider the fewer are expected
+    uint32 GetWindowFloor(BattlegroundBracketId bracket_id, uint32 minWindow, uint32 maxWindow) const;
+
+private:
+    static uint32 GetHourOfWeek(uint32 unixTime) { return (unixTime / HOUR) % SOLO_FORECAST_HOURS; }
+
+    void CloseHour();
+    void Predict(uint32 now);
+
+    bool enabled = false;
+    float smoothing = 0.3f;
+    float busyJoins = 30.0f;
+
+    uint32 predictTimer = 0;
+    uint32 countedHour = SOLO_FORECAST_HOURS;           // hour of the week counts belongs to, SOLO_FORECAST_HOURS = none yet
+    bool countedHourComplete = false;                   // false for the hour the server started in
+
+    float averages[SOLO_FORECAST_HOURS][MAX_BATTLEGROUND_BRACKETS][MAX_TALENT_CAT] = { };
+    std::bitset<SOLO_FORECAST_HOURS> knownHours;
+    uint32 counts[MAX_BATTLEGROUND_BRACKETS][MAX_TALENT_CAT] = { };
+    float predicted[MAX_BATTLEGROUND_BRACKETS][MAX_TALENT_CAT] = { };
+    bool predictionReady = false;
+};
+
+#define sSoloForecast Solo3v3Forecast::instance()
+
+#endif // _SOLO_3V3_FORECAST_H_
@@ -0,0 +1,150 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_invite.h"
+#include "solo3v3_db.h"
+#include "solo3v3_memory.h"
+#include "Config.h"
+#include "DatabaseEnv.h"
+#include "Log.h"
+#include "Timer.h"
+
+// Counts are halved at this many invites, so the rate follows the last few dozen invites
+constexpr uint16 SOLO_INVITE_WINDOW = 32;
+constexpr uint32 SOLO_INVITE_SAVE_INTERVAL = 5 * MINUTE * IN_MILLISECONDS;
+
+static bool InviteGuidLess(Solo3v3InviteEntry const& entry, ObjectGuid::LowType guid)
+{
+    return entry.Guid < guid;
+}
+
+Solo3v3InviteTracker* Solo3v3InviteTracker::instance()
+{
+    static Solo3v3InviteTracker instance;
+    return &instance;
+}
+
+void Solo3v3InviteTracker::LoadConfig()
+{
+    enabled = sConfigMgr->GetOption<bool>("Solo.3v3.Decliner.Enable", false);
+    minInvites = std::max<uint32>(1, sConfigMgr->GetOption<uint32>("Solo.3v3.Decliner.MinInvites", 5));
+    minAcceptRate = std::min<uint32>(100, sConfigMgr->GetOption<uint32>("Solo.3v3.Decliner.MinAcceptRate", 70));
+    penalty = sConfigMgr->GetOption<uint32>("Solo.3v3.Decliner.Penalty", 120) * IN_MILLISECONDS;
+}
+
+void Solo3v3InviteTracker::LoadFromDB()
+{
+    uint32 oldMSTime = getMSTime();
+
+    entries.clear();
+    dirtyGuids.clear();
+
+    QueryResult result = CharacterDatabase.Query(GetSolo3v3Statement(SOLO_SEL_INVITES));
+    if (!result)
+        return;
+
+    entries.reserve(result->GetRowCount());
+
+    do
+    {
+        Field* fields = result->Fetch();
+
+        Solo3v3InviteEntry entry;
+        entry.Guid = fields[0].Get<uint32>();
+        entry.Invites = fields[1].Get<uint16>();
+        entry.Accepts = std::min(fields[2].Get<uint16>(), entry.Invites);
+        entries.push_back(entry);
+    } while (result->NextRow());
+
+    LOG_INFO("module", ">> Loaded {} solo 3v3 invite records in {} ms", entries.size(), GetMSTimeDiffToNow(oldMSTime));
+}
+
+void Solo3v3InviteTracker::SaveToDB()
+{
+    if (dirtyGuids.empty())
+        return;
+
+    CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
+
+    for (ObjectGuid::LowType guid : dirtyGuids)
+    {
+        auto itr = std::lower_bound(entries.begin(), entries.end(), guid, InviteGuidLess);
+        if (itr != entries.end() && itr->Guid == guid)
+            trans->Append(GetSolo3v3Statement(SOLO_REP_INVITE), itr->Guid, itr->Invites, itr->Accepts);
+    }
+
+    dirtyGuids.clear();
+    CharacterDatabase.CommitTransaction(trans);
+}
+
+void Solo3v3InviteTracker::Update(uint32 diff)
+{
+    if (!enabled)
+        return;
+
+    saveTimer += diff;
+    if (saveTimer < SOLO_INVITE_SAVE_INTERVAL)
+        return;
+
+    saveTimer = 0;
+    SaveToDB();
+}
+
+void Solo3v3InviteTracker::Record(ObjectGuid guid, bool accepted)
+{
+    if (!enabled)
+        return;
+
+    ObjectGuid::LowType lowGuid = guid.GetCounter();
+
+    auto itr = std::lower_bound(entries.begin(), entries.end(), lowGuid, InviteGuidLess);
+    if (itr == entries.end() || itr->Guid != lowGuid)
+    {
+        Solo3v3InviteEntry entry;
+        entry.Guid = lowGuid;
+        itr = entries.insert(itr, entry);
+    }
+
+    if (itr->Invites >= SOLO_INVITE_WINDOW)
+    {
+        itr->Invites /= 2;
+        itr->Accepts /= 2;
+    }
+
+    itr->Invites++;
+    if (accepted)
+        itr->Accepts++;
+
+    if (std::find(dirtyGuids.begin(), dirtyGuids.end(), lowGuid) == dirtyGuids.end())
+        dirtyGuids.push_back(lowGuid);
+}
+
+uint32 Solo3v3InviteTracker::GetAcceptRate(ObjectGuid guid) const
+{
+    ObjectGuid::LowType lowGuid = guid.GetCounter();
+
+    auto itr = std::lower_bound(entries.begin(), entries.end(), lowGuid, InviteGuidLess);
+    if (itr == entries.end() || itr->Guid != lowGuid || itr->Invites < minInvites)
+        return 100;
+
+    return itr->Accepts * 100 / itr->Invites;
+}
+
+void Solo3v3InviteTracker::ReportMemory(Solo3v3MemoryReport& report) const
+{
+    report.Add("invite records", Solo3v3VectorBytes(entries) + Solo3v3VectorBytes(dirtyGuids), entries.size());
+}
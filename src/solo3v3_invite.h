@@ -0,0 +1,78 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_INVITE_H_
+#define _SOLO_3V3_INVITE_H_
+
+#include "solo3v3.h"
+
+// Invite outcomes of one player, sorted by guid
+struct Solo3v3InviteEntry
+{
+    ObjectGuid::LowType Guid = 0;
+    uint16 Invites = 0;             // invites resolved, halved together with Accepts when reaching SOLO_INVITE_WINDOW
+    uint16 Accepts = 0;             // invites the player entered the arena for
+};
+
+/*
+ * Solo arena invite acceptance per player.
+ *
+ * An invite counts as accepted when the player enters the arena and as declined when the player
+ * is replaced by backfill or still missing when the gates open, both end up wasting the match of
+ * five others. Players that accept less than Solo.3v3.Decliner.MinAcceptRate percent are held
+ * back by the matcher until they waited Solo.3v3.Decliner.Penalty, players that accept their
+ * invites are matched first.
+ */
+class Solo3v3InviteTracker
+{
+public:
+    static Solo3v3InviteTracker* instance();
+
+    void LoadConfig();
+    void LoadFromDB();
+    void SaveToDB();
+    void Update(uint32 diff);
+    void ReportMemory(Solo3v3MemoryReport& report) const;
+
+    bool IsEnabled() const { return enabled; }
+
+    void OnAccepted(ObjectGuid guid) { Record(guid, true); }
+    void OnDeclined(ObjectGuid guid) { Record(guid, false); }
+
+    // Percentage of the recent invites the player accepted, 100 until MinInvites are known
+    uint32 GetAcceptRate(ObjectGuid guid) const;
+    bool IsDecliner(ObjectGuid guid) const { return enabled && GetAcceptRate(guid) < minAcceptRate; }
+
+    // True while a decliner queued for less than the penalty (waitedMs since joining)
+    bool IsHeldBack(ObjectGuid guid, uint32 waitedMs) const { return waitedMs < penalty && IsDecliner(guid); }
+
+private:
+    void Record(ObjectGuid guid, bool accepted);
+
+    bool enabled = false;
+    uint32 minInvites = 5;
+    uint32 minAcceptRate = 70;
+    uint32 penalty = 2 * MINUTE * IN_MILLISECONDS;
+    uint32 saveTimer = 0;
+
+    std::vector<Solo3v3InviteEntry> entries;
+    std::vector<ObjectGuid::LowType> dirtyGuids;
+};
+
+#define sSoloInvites Solo3v3InviteTracker::instance()
+
+#endif // _SOLO_3V3_INVITE_H_
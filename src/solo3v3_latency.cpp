@@ -0,0 +1,102 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_latency.h"
+#include "Chat.h"
+#include "Timer.h"
+
+static char const* const StageIntervalNames[MAX_SOLO_STAGES] =
+{
+    "",
+    "queue wait",           // join -> selected
+    "arena creation",       // selected -> teams created
+    "invite",               // teams created -> invited
+    "invite accept",        // invited -> last player entered
+    "preparation",          // last player entered -> gates open
+    "match",                // gates open -> match end
+    "rating save"           // match end -> ratings saved
+};
+
+void Solo3v3LatencyHistogram::Add(uint32 ms)
+{
+    uint32 bucket = 0;
+    while (bucket < SOLO_LATENCY_BUCKETS - 1 && ms >= (1u << bucket))
+        bucket++;
+
+    buckets[bucket]++;
+    count++;
+    max = std::max(max, ms);
+    sum += ms;
+}
+
+uint32 Solo3v3LatencyHistogram::GetPercentile(uint32 percent) const
+{
+    if (!count)
+        return 0;
+
+    uint32 rank = std::max<uint32>(1, uint32(uint64(count) * percent / 100));
+    uint32 seen = 0;
+
+    for (uint32 bucket = 0; bucket < SOLO_LATENCY_BUCKETS; bucket++)
+    {
+        seen += buckets[bucket];
+        if (seen >= rank)
+            return bucket + 1 < SOLO_LATENCY_BUCKETS ? std::min(max, (1u << bucket) - 1) : max;
+    }
+
+    return max;
+}
+
+Solo3v3LatencyStats* Solo3v3LatencyStats::instance()
+{
+    static Solo3v3LatencyStats instance;
+    return &instance;
+}
+
+void Solo3v3LatencyStats::Record(Solo3v3ArenaInfo const& info)
+{
+    arenas++;
+
+    // Stages an arena never reached (declined invite, crash) leave both neighbouring intervals out
+    for (uint32 stage = SOLO_STAGE_SELECTED; stage < MAX_SOLO_STAGES; stage++)
+        if (info.StageTime[stage - 1] && info.StageTime[stage])
+            stages[stage].Add(getMSTimeDiff(info.StageTime[stage - 1], info.StageTime[stage]));
+
+    if (!info.StageTime[SOLO_STAGE_INVITED])
+        return;
+
+    for (uint32 teamId = 0; teamId < BG_TEAMS_COUNT; teamId++)
+        for (uint8 slot = 0; slot < info.PlayerCount[teamId]; slot++)
+            if (info.AcceptTime[teamId][slot])
+                accept.Add(getMSTimeDiff(info.StageTime[SOLO_STAGE_INVITED], info.AcceptTime[teamId][slot]));
+}
+
+void Solo3v3LatencyStats::Print(ChatHandler* handler) const
+{
+    handler->PSendSysMessage("Solo 3v3 stage latencies of %u arenas, in ms (percentiles are bucket upper bounds):", arenas);
+
+    auto printHistogram = [handler](char const* name, Solo3v3LatencyHistogram const& histogram)
+    {
+        handler->PSendSysMessage("%s: %u samples, avg %u, p50 %u, p90 %u, p99 %u, max %u", name, histogram.GetCount(),
+            histogram.GetAverage(), histogram.GetPercentile(50), histogram.GetPercentile(90), histogram.GetPercentile(99), histogram.GetMax());
+    };
+
+    for (uint32 stage = SOLO_STAGE_SELECTED; stage < MAX_SOLO_STAGES; stage++)
+        printHistogram(StageIntervalNames[stage], stages[stage]);
+
+    printHistogram("player accept", accept);
+}
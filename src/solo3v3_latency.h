@@ -0,0 +1,70 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_LATENCY_H_
+#define _SOLO_3V3_LATENCY_H_
+
+#include "solo3v3.h"
+
+class ChatHandler;
+
+constexpr uint32 SOLO_LATENCY_BUCKETS = 24;     // power of two ms buckets, the last one holds everything from ~70 minutes
+
+class Solo3v3LatencyHistogram
+{
+public:
+    void Add(uint32 ms);
+
+    uint32 GetCount() const { return count; }
+    uint32 GetMax() const { return max; }
+    uint32 GetAverage() const { return count ? uint32(sum / count) : 0; }
+    // Upper bound of the bucket holding the given percentile
+    uint32 GetPercentile(uint32 percent) const;
+
+private:
+    uint32 buckets[SOLO_LATENCY_BUCKETS] = { };
+    uint32 count = 0;
+    uint32 max = 0;
+    uint64 sum = 0;
+};
+
+/*
+ * Per-stage latencies of the solo arenas since startup.
+ *
+ * Every arena context carries the time each Solo3v3MatchStage was reached. When the battleground
+ * is destroyed the time between two consecutive stages is added to the histogram of the later
+ * stage, and the time each player took to enter after the invite to the accept histogram.
+ * Shown by .soloq latency.
+ */
+class Solo3v3LatencyStats
+{
+public:
+    static Solo3v3LatencyStats* instance();
+
+    void Record(Solo3v3ArenaInfo const& info);
+
+    void Print(ChatHandler* handler) const;
+
+private:
+    Solo3v3LatencyHistogram stages[MAX_SOLO_STAGES];    // [stage] = time from the stage before, [0] unused
+    Solo3v3LatencyHistogram accept;
+    uint32 arenas = 0;
+};
+
+#define sSoloLatency Solo3v3LatencyStats::instance()
+
+#endif // _SOLO_3V3_LATENCY_H_
@@ -0,0 +1,201 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_leaver.h"
+#include "solo3v3_db.h"
+#include "solo3v3_memory.h"
+#include "Chat.h"
+#include "Config.h"
+#include "DatabaseEnv.h"
+#include "GameTime.h"
+#include "Log.h"
+#include "Timer.h"
+#include <cmath>
+
+// Entries below this score and without lockout are forgotten
+constexpr float SOLO_LEAVER_MIN_SCORE = 0.05f;
+
+static bool LeaverGuidLess(Solo3v3LeaverEntry const& entry, ObjectGuid::LowType guid)
+{
+    return entry.Guid < guid;
+}
+
+Solo3v3LeaverTracker* Solo3v3LeaverTracker::instance()
+{
+    static Solo3v3LeaverTracker instance;
+    return &instance;
+}
+
+void Solo3v3LeaverTracker::LoadConfig()
+{
+    enabled = sConfigMgr->GetOption<bool>("Solo.3v3.Leaver.Enable", false);
+    halfLife = std::max<float>(1.0f, sConfigMgr->GetOption<float>("Solo.3v3.Leaver.HalfLife", 72.0f) * HOUR);
+    threshold = std::max<uint32>(1, sConfigMgr->GetOption<uint32>("Solo.3v3.Leaver.Threshold", 2));
+    lockoutBase = sConfigMgr->GetOption<uint32>("Solo.3v3.Leaver.LockoutBase", 5) * MINUTE;
+    lockoutMax = sConfigMgr->GetOption<uint32>("Solo.3v3.Leaver.LockoutMax", 1440) * MINUTE;
+    saveInterval = sConfigMgr->GetOption<uint32>("Solo.3v3.Leaver.SaveInterval", 300) * IN_MILLISECONDS;
+}
+
+void Solo3v3LeaverTracker::LoadFromDB()
+{
+    uint32 oldMSTime = getMSTime();
+
+    std::lock_guard<std::mutex> guard(lock);
+    entries.clear();
+    dirtyGuids.clear();
+
+    QueryResult result = CharacterDatabase.Query(GetSolo3v3Statement(SOLO_SEL_LEAVERS));
+    if (!result)
+        return;
+
+    entries.reserve(result->GetRowCount());
+
+    do
+    {
+        Field* fields = result->Fetch();
+
+        Solo3v3LeaverEntry entry;
+        entry.Guid = fields[0].Get<uint32>();
+        entry.Score = fields[1].Get<float>();
+        entry.LastUpdate = fields[2].Get<uint32>();
+        entry.LockoutUntil = fields[3].Get<uint32>();
+        entries.push_back(entry);
+    } while (result->NextRow());
+
+    LOG_INFO("module", ">> Loaded {} solo 3v3 leaver entries in {} ms", entries.size(), GetMSTimeDiffToNow(oldMSTime));
+}
+
+void Solo3v3LeaverTracker::SaveToDB()
+{
+    uint32 now = GameTime::GetGameTime().count();
+    CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
+
+    std::lock_guard<std::mutex> guard(lock);
+    bool changed = !dirtyGuids.empty();
+
+    for (ObjectGuid::LowType guid : dirtyGuids)
+    {
+        if (Solo3v3LeaverEntry* entry = Find(guid))
+            trans->Append(GetSolo3v3Statement(SOLO_REP_LEAVER), entry->Guid, entry->Score, entry->LastUpdate, entry->LockoutUntil);
+    }
+
+    dirtyGuids.clear();
+
+    // Forget players that stopped leaving long enough ago
+    auto itr = std::remove_if(entries.begin(), entries.end(), [&](Solo3v3LeaverEntry& entry)
+    {
+        Decay(entry, now);
+        if (entry.Score >= SOLO_LEAVER_MIN_SCORE || entry.LockoutUntil > now)
+            return false;
+
+        trans->Append(GetSolo3v3Statement(SOLO_DEL_LEAVER), entry.Guid);
+        changed = true;
+        return true;
+    });
+
+    entries.erase(itr, entries.end());
+
+    if (changed)
+        CharacterDatabase.CommitTransaction(trans);
+}
+
+void Solo3v3LeaverTracker::Update(uint32 diff)
+{
+    if (!enabled)
+        return;
+
+    saveTimer += diff;
+    if (saveTimer < saveInterval)
+        return;
+
+    saveTimer = 0;
+    SaveToDB();
+}
+
+void Solo3v3LeaverTracker::OnLeave(Player* player)
+{
+    if (!enabled)
+        return;
+
+    uint32 now = GameTime::GetGameTime().count();
+    ObjectGuid::LowType guid = player->GetGUID().GetCounter();
+    uint32 lockoutUntil;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        auto itr = std::lower_bound(entries.begin(), entries.end(), guid, LeaverGuidLess);
+        if (itr == entries.end() || itr->Guid != guid)
+        {
+            Solo3v3LeaverEntry entry;
+            entry.Guid = guid;
+            entry.LastUpdate = now;
+            itr = entries.insert(itr, entry);
+        }
+
+        Decay(*itr, now);
+        itr->Score += 1.0f;
+        dirtyGuids.insert(guid);
+
+        if (itr->Score < float(threshold))
+            return;
+
+        // doubles with every full point above the threshold
+        uint32 level = std::min<uint32>(uint32(itr->Score) - threshold, 16);
+        uint32 lockout = std::min<uint64>(uint64(lockoutBase) << level, lockoutMax);
+        itr->LockoutUntil = std::max(itr->LockoutUntil, now + lockout);
+        lockoutUntil = itr->LockoutUntil;
+    }
+
+    ChatHandler(player->GetSession()).PSendSysMessage("You left too many solo arenas, you can not queue for %u minutes.", (lockoutUntil - now + MINUTE - 1) / MINUTE);
+}
+
+uint32 Solo3v3LeaverTracker::GetLockoutRemaining(ObjectGuid guid) const
+{
+    if (!enabled)
+        return 0;
+
+    ObjectGuid::LowType lowGuid = guid.GetCounter();
+    std::lock_guard<std::mutex> guard(lock);
+    auto itr = std::lower_bound(entries.begin(), entries.end(), lowGuid, LeaverGuidLess);
+    if (itr == entries.end() || itr->Guid != lowGuid)
+        return 0;
+
+    uint32 now = GameTime::GetGameTime().count();
+    return itr->LockoutUntil > now ? itr->LockoutUntil - now : 0;
+}
+
+Solo3v3LeaverEntry* Solo3v3LeaverTracker::Find(ObjectGuid::LowType guid)
+{
+    auto itr = std::lower_bound(entries.begin(), entries.end(), guid, LeaverGuidLess);
+    return itr != entries.end() && itr->Guid == guid ? &*itr : nullptr;
+}
+
+void Solo3v3LeaverTracker::Decay(Solo3v3LeaverEntry& entry, uint32 now) const
+{
+    if (now <= entry.LastUpdate)
+        return;
+
+    entry.Score *= std::exp2(-float(now - entry.LastUpdate) / halfLife);
+    entry.LastUpdate = now;
+}
+
+void Solo3v3LeaverTracker::ReportMemory(Solo3v3MemoryReport& report) const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    report.Add("leaver entries", Solo3v3VectorBytes(entries) + Solo3v3HashBytes(dirtyGuids), entries.size());
+}
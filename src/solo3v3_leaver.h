@@ -0,0 +1,79 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_LEAVER_H_
+#define _SOLO_3V3_LEAVER_H_
+
+#include "solo3v3.h"
+#include <unordered_set>
+
+// 16 bytes per player that left a solo arena recently, kept sorted by guid
+struct Solo3v3LeaverEntry
+{
+    ObjectGuid::LowType Guid = 0;
+    uint32 LastUpdate = 0;          // unix time Score was decayed to
+    uint32 LockoutUntil = 0;        // unix time, queueing is refused before
+    float Score = 0.0f;             // +1 per leave, halves every Solo.3v3.Leaver.HalfLife
+};
+
+/*
+ * Escalating queue lockouts for players leaving solo arenas.
+ *
+ * Every leave adds 1 to a score that decays exponentially, from Solo.3v3.Leaver.Threshold on each
+ * leave locks the player out of the queue, twice as long per point above the threshold.
+ * Changed entries are written to the characters database every Solo.3v3.Leaver.SaveInterval and
+ * on shutdown, not on every leave.
+ * Leaves are reported and lockouts checked from map threads, the entries are guarded by lock.
+ */
+class Solo3v3LeaverTracker
+{
+public:
+    static Solo3v3LeaverTracker* instance();
+
+    void LoadConfig();
+    void LoadFromDB();
+    void SaveToDB();
+    void Update(uint32 diff);
+    void ReportMemory(Solo3v3MemoryReport& report) const;
+
+    bool IsEnabled() const { return enabled; }
+
+    void OnLeave(Player* player);
+
+    // Seconds the player still has to wait before joining, 0 when free to queue
+    uint32 GetLockoutRemaining(ObjectGuid guid) const;
+
+private:
+    Solo3v3LeaverEntry* Find(ObjectGuid::LowType guid);
+    void Decay(Solo3v3LeaverEntry& entry, uint32 now) const;
+
+    bool enabled = false;
+    float halfLife = 72.0f * HOUR;
+    uint32 threshold = 2;
+    uint32 lockoutBase = 5 * MINUTE;
+    uint32 lockoutMax = DAY;
+    uint32 saveInterval = 5 * MINUTE * IN_MILLISECONDS;
+    uint32 saveTimer = 0;
+
+    mutable std::mutex lock;                    // guards entries and dirtyGuids
+    std::vector<Solo3v3LeaverEntry> entries;
+    std::unordered_set<ObjectGuid::LowType> dirtyGuids;
+};
+
+#define sSoloLeaver Solo3v3LeaverTracker::instance()
+
+#endif // _SOLO_3V3_LEAVER_H_
@@ -0,0 +1,118 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_memory.h"
+#include "solo3v3.h"
+#include "solo3v3_events.h"
+#include "solo3v3_forecast.h"
+#include "solo3v3_invite.h"
+#include "solo3v3_latency.h"
+#include "solo3v3_leaver.h"
+#include "solo3v3_rating.h"
+#include "solo3v3_remote.h"
+#include "solo3v3_roles.h"
+#include "solo3v3_shadow.h"
+#include "solo3v3_tournament.h"
+#include "solo3v3_trace.h"
+#include "Chat.h"
+#include "Config.h"
+#include "Log.h"
+#include "StringFormat.h"
+
+Solo3v3MemoryStats* Solo3v3MemoryStats::instance()
+{
+    static Solo3v3MemoryStats instance;
+    return &instance;
+}
+
+void Solo3v3MemoryStats::LoadConfig()
+{
+    logInterval = sConfigMgr->GetOption<uint32>("Solo.3v3.MemoryLog.Interval", 0) * IN_MILLISECONDS;
+}
+
+void Solo3v3MemoryStats::Update(uint32 diff)
+{
+    sampleTimer += diff;
+    if (sampleTimer >= SOLO_3V3_MEMORY_SAMPLE_INTERVAL)
+    {
+        sampleTimer = 0;
+        Collect(false);
+    }
+
+    if (!logInterval)
+        return;
+
+    logTimer += diff;
+    if (logTimer < logInterval)
+        return;
+
+    logTimer = 0;
+
+    Solo3v3MemoryReport report = Collect(false);
+    size_t total = 0;
+    std::string line;
+
+    for (auto const& entry : report.GetEntries())
+    {
+        total += entry.Bytes;
+        line += Acore::StringFormat(" {}={}", entry.Name, entry.Bytes);
+    }
+
+    LOG_INFO("module", "Solo3v3 memory: {} bytes,{}", total, line);
+}
+
+void Solo3v3MemoryStats::Print(ChatHandler* handler)
+{
+    Solo3v3MemoryReport report = Collect(true);
+    size_t total = 0;
+
+    handler->SendSysMessage("Solo 3v3 module memory (bytes, estimated from container sizes):");
+
+    for (auto const& entry : report.GetEntries())
+    {
+        total += entry.Bytes;
+        handler->PSendSysMessage("%s: %u in %u entries, peak %u", entry.Name, uint32(entry.Bytes), uint32(entry.Count), uint32(peaks[entry.Name]));
+    }
+
+    handler->PSendSysMessage("Total: %u", uint32(total));
+}
+
+Solo3v3MemoryReport Solo3v3MemoryStats::Collect(bool walkTempTeams)
+{
+    Solo3v3MemoryReport report;
+
+    sSolo->ReportMemory(report, walkTempTeams);
+    sSoloRoles->ReportMemory(report);
+    sSoloRating->ReportMemory(report);
+    sSoloForecast->ReportMemory(report);
+    sSoloLeaver->ReportMemory(report);
+    sSoloInvites->ReportMemory(report);
+    sSoloTournament->ReportMemory(report);
+    sSoloShadow->ReportMemory(report);
+    sSoloRemote->ReportMemory(report);
+    sSoloEvents->ReportMemory(report);
+    sSoloTrace->ReportMemory(report);
+    report.Add("latency histograms", sizeof(Solo3v3LatencyStats), 1);
+
+    for (auto const& entry : report.GetEntries())
+    {
+        size_t& peak = peaks[entry.Name];
+        peak = std::max(peak, entry.Bytes);
+    }
+
+    return report;
+}
@@ -0,0 +1,87 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_MEMORY_H_
+#define _SOLO_3V3_MEMORY_H_
+
+#include "Common.h"
+#include <unordered_map>
+
+class ChatHandler;
+
+constexpr uint32 SOLO_3V3_MEMORY_SAMPLE_INTERVAL = 1 * IN_MILLISECONDS;
+
+// Bytes held by standard containers: the element storage, plus node and bucket overhead of hash containers
+template<typename T>
+size_t Solo3v3VectorBytes(std::vector<T> const& container)
+{
+    return container.capacity() * sizeof(T);
+}
+
+template<typename HashContainer>
+size_t Solo3v3HashBytes(HashContainer const& container)
+{
+    return container.size() * (sizeof(typename HashContainer::value_type) + 2 * sizeof(void*)) + container.bucket_count() * sizeof(void*);
+}
+
+// Filled by the ReportMemory() of every module object owning containers
+class Solo3v3MemoryReport
+{
+public:
+    struct Entry
+    {
+        char const* Name;
+        size_t Bytes;
+        size_t Count;       // elements held
+    };
+
+    void Add(char const* name, size_t bytes, size_t count) { entries.push_back({ name, bytes, count }); }
+    std::vector<Entry> const& GetEntries() const { return entries; }
+
+private:
+    std::vector<Entry> entries;
+};
+
+/*
+ * Memory accounting of the module. Collect() asks every owner for its containers and keeps the
+ * high-water mark of each. The peaks are sampled every SOLO_3V3_MEMORY_SAMPLE_INTERVAL whether
+ * logging is on or not, printed by .soloq memory and logged every Solo.3v3.MemoryLog.Interval.
+ * The numbers are estimates from sizes and capacities, allocator overhead is not included. Only
+ * .soloq memory walks the arena team manager for the temp teams, the samples use running totals.
+ */
+class Solo3v3MemoryStats
+{
+public:
+    static Solo3v3MemoryStats* instance();
+
+    void LoadConfig();
+    void Update(uint32 diff);
+
+    void Print(ChatHandler* handler);
+
+private:
+    Solo3v3MemoryReport Collect(bool walkTempTeams);
+
+    uint32 logInterval = 0;
+    uint32 logTimer = 0;
+    uint32 sampleTimer = 0;
+    std::unordered_map<std::string, size_t> peaks;
+};
+
+#define sSoloMemory Solo3v3MemoryStats::instance()
+
+#endif // _SOLO_3V3_MEMORY_H_
@@ -0,0 +1,194 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_pack.h"
+#include <algorithm>
+
+void Solo3v3SortOldestFirst(std::vector<Solo3v3PackGroup>& groups)
+{
+    // Index breaks ties in collection order: as stable as std::stable_sort without its temporary buffer
+    std::sort(groups.begin(), groups.end(), [](Solo3v3PackGroup const& a, Solo3v3PackGroup const& b)
+    {
+        return a.Waited != b.Waited ? a.Waited > b.Waited : a.Index < b.Index;
+    });
+}
+
+bool Solo3v3PackTeams(std::vector<Solo3v3PackGroup>& groups, Solo3v3PackOptions const& options, bool duosFirst, int32 anchor, uint32 window, bool& placedDuo)
+{
+    uint32 teamPlayers[SOLO_PACK_SIDES] = { };
+    bool roleTaken[SOLO_PACK_SIDES][SOLO_PACK_ROLES] = { };
+    uint32 selected = 0;
+    placedDuo = false;
+
+    for (Solo3v3PackGroup& group : groups)
+        group.Result = SOLO_PACK_NOT_PLACED;
+
+    auto place = [&](Solo3v3PackGroup& group)
+    {
+        // a duo of one role can never be placed while filtering talents
+        if (options.FilterTalents && group.Size == 2 && group.Roles[0] == group.Roles[1])
+        {
+            group.Result = SOLO_PACK_REJECT_ROLE_TAKEN;
+            return false;
+        }
+
+        for (uint8 side = 0; side < SOLO_PACK_SIDES; side++)
+        {
+            if (teamPlayers[side] + group.Size > SOLO_PACK_TEAM_SIZE)
+                continue;
+
+            if (options.FilterTalents && (roleTaken[side][group.Roles[0]] || (group.Size == 2 && roleTaken[side][group.Roles[1]])))
+                continue;
+
+            for (uint8 i = 0; i < group.Size; i++)
+                roleTaken[side][group.Roles[i]] = true;
+
+            teamPlayers[side] += group.Size;
+            selected += group.Size;
+            placedDuo = placedDuo || group.Size == 2;
+            group.Side = side;
+            group.Result = SOLO_PACK_SELECTED;
+            return true;
+        }
+
+        group.Result = SOLO_PACK_REJECT_ROLE_TAKEN;
+        return false;
+    };
+
+    uint32 anchorMMR = 0;
+    if (anchor >= 0)
+    {
+        Solo3v3PackGroup& first = groups[anchor];
+        if ((!duosFirst && first.Size == 2) || !place(first))
+            return false;
+
+        anchorMMR = first.MMR;
+    }
+
+    // Every pass walks the groups once: first the duos, then the solos (first fit, oldest first)
+    for (uint8 size = duosFirst ? 2 : 1; size >= 1 && selected < SOLO_PACK_MATCH_SIZE; size--)
+    {
+        for (uint32 i = 0; i < groups.size() && selected < SOLO_PACK_MATCH_SIZE; i++)
+        {
+            Solo3v3PackGroup& group = groups[i];
+            if (group.Size != size || int32(i) == anchor)
+                continue;
+
+            if (anchor >= 0)
+            {
+                uint32 difference = group.MMR > anchorMMR ? group.MMR - anchorMMR : anchorMMR - group.MMR;
+                if (difference > window)
+                {
+                    group.Result = SOLO_PACK_REJECT_MMR_WINDOW;
+                    continue;
+                }
+            }
+
+            place(group);
+        }
+    }
+
+    return selected == SOLO_PACK_MATCH_SIZE;
+}
+
+Solo3v3SelectionCheck Solo3v3CheckSelection(Solo3v3SelectedGroup const* groups, uint32 count, bool filterTalents)
+{
+    uint32 teamPlayers[SOLO_PACK_SIDES] = { };
+    bool roleTaken[SOLO_PACK_SIDES][SOLO_PACK_ROLES] = { };
+    Solo3v3SelectionCheck check;
+
+    auto fail = [&check](Solo3v3SelectionError error, uint32 group)
+    {
+        check.Error = error;
+        check.Group = group;
+        return check;
+    };
+
+    if (count > SOLO_PACK_MATCH_SIZE)
+        return fail(SOLO_SELECTION_TOO_MANY_GROUPS, SOLO_PACK_MATCH_SIZE);
+
+    for (uint32 i = 0; i < count; i++)
+    {
+        Solo3v3SelectedGroup const& group = groups[i];
+
+        for (uint32 j = 0; j < i; j++)
+        {
+            if (groups[j].Key == group.Key)
+                return fail(SOLO_SELECTION_GROUP_TWICE, i);
+
+            for (uint8 a = 0; a < groups[j].Size; a++)
+                for (uint8 b = 0; b < group.Size; b++)
+                    if (groups[j].Players[a] == group.Players[b])
+                        return fail(SOLO_SELECTION_PLAYER_TWICE, i);
+        }
+
+        if (group.Invited)
+            return fail(SOLO_SELECTION_INVITED, i);
+
+        // the faction swap must have moved the group into the list of its new team
+        if (group.Side >= SOLO_PACK_SIDES || group.ListSide != group.Side)
+            return fail(SOLO_SELECTION_WRONG_LIST, i);
+
+        if (group.Size < 1 || group.Size > 2)
+            return fail(SOLO_SELECTION_TEAM_SIZE, i);
+
+        for (uint8 p = 0; p < group.Size; p++)
+        {
+            if (!group.Queued[p])
+                return fail(SOLO_SELECTION_NOT_QUEUED, i);
+
+            if (group.Size == 2 && group.Players[0] == group.Players[1])
+                return fail(SOLO_SELECTION_PLAYER_TWICE, i);
+
+            if (!filterTalents)
+                continue;
+
+            if (group.Roles[p] >= SOLO_PACK_ROLES || roleTaken[group.Side][group.Roles[p]])
+                return fail(SOLO_SELECTION_ROLE_TWICE, i);
+
+            roleTaken[group.Side][group.Roles[p]] = true;
+        }
+
+        teamPlayers[group.Side] += group.Size;
+        if (teamPlayers[group.Side] > SOLO_PACK_TEAM_SIZE)
+            return fail(SOLO_SELECTION_TEAM_SIZE, i);
+    }
+
+    for (uint8 side = 0; side < SOLO_PACK_SIDES; side++)
+        if (teamPlayers[side] != SOLO_PACK_TEAM_SIZE)
+            return fail(SOLO_SELECTION_TEAM_SIZE, count ? count - 1 : 0);
+
+    return check;
+}
+
+char const* Solo3v3SelectionErrorText(Solo3v3SelectionError error)
+{
+    switch (error)
+    {
+        case SOLO_SELECTION_OK:                 return "ok";
+        case SOLO_SELECTION_TOO_MANY_GROUPS:    return "too many groups";
+        case SOLO_SELECTION_GROUP_TWICE:        return "group selected twice";
+        case SOLO_SELECTION_PLAYER_TWICE:       return "player selected twice";
+        case SOLO_SELECTION_INVITED:            return "group already invited to an instance";
+        case SOLO_SELECTION_WRONG_LIST:         return "group not in the queue list of its team";
+        case SOLO_SELECTION_NOT_QUEUED:         return "player no longer queued";
+        case SOLO_SELECTION_ROLE_TWICE:         return "role taken twice in a team";
+        case SOLO_SELECTION_TEAM_SIZE:          return "team does not have three players";
+    }
+
+    return "?";
+}
@@ -0,0 +1,149 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_PACK_H_
+#define _SOLO_3V3_PACK_H_
+
+#include "Define.h"
+#include <vector>
+
+/*
+ * Core of the solo matcher: packing queued groups into two teams and checking the result.
+ *
+ * Nothing in here knows about players, queues or battlegrounds, the callers copy what the
+ * matcher needs into Solo3v3PackGroup / Solo3v3SelectedGroup first. That keeps the decisions in
+ * one place for Solo3v3::CheckSolo3v3Arena and the fuzz target in fuzz/, which drives them with
+ * random queue operations and asserts the invariants after every step. The test in test/ checks
+ * that a queue update reusing its buffers does not allocate.
+ */
+
+constexpr uint32 SOLO_PACK_TEAM_SIZE = 3;
+constexpr uint32 SOLO_PACK_SIDES = 2;
+constexpr uint32 SOLO_PACK_MATCH_SIZE = SOLO_PACK_TEAM_SIZE * SOLO_PACK_SIDES;
+constexpr uint8 SOLO_PACK_ROLES = 3;                   // MELEE, RANGE, HEALER of Solo3v3TalentCat
+
+// What the last packing attempt did with a group
+enum Solo3v3PackResult : uint8
+{
+    SOLO_PACK_NOT_PLACED = 0,
+    SOLO_PACK_SELECTED,
+    SOLO_PACK_REJECT_MMR_WINDOW,
+    SOLO_PACK_REJECT_ROLE_TAKEN
+};
+
+// A queued group the matcher may pick, only groups that can play right now (online, not invited)
+struct Solo3v3PackGroup
+{
+    uint32 MMR = 0;
+    uint32 Waited = 0;                                  // ms in the queue
+    uint8 Size = 1;                                     // 1 or 2 players
+    uint8 Roles[2] = { };
+    uint32 Index = 0;                                   // the caller's index of the group, kept when sorted
+
+    // Written by the packer
+    uint8 Side = 0;
+    Solo3v3PackResult Result = SOLO_PACK_NOT_PLACED;
+};
+
+struct Solo3v3PackOptions
+{
+    bool FilterTalents = true;                          // one player of every role per team
+    bool AllowDuos = false;                             // place duos before the solos
+    bool UseWindow = false;                             // only match groups close in MMR to the anchor
+    uint32 MaxAnchors = 1;                              // groups tried as anchor, 0 = every group
+};
+
+// Orders the groups of both queue lists by wait time, longest first, as the packer expects them.
+// Equal waits keep the order of Index. Does not allocate.
+void Solo3v3SortOldestFirst(std::vector<Solo3v3PackGroup>& groups);
+
+// One first fit pass, oldest first. anchor: index of the group placed first and whose MMR the others
+// must be within window of, -1 for none. placedDuo tells if a duo was placed in the attempt.
+bool Solo3v3PackTeams(std::vector<Solo3v3PackGroup>& groups, Solo3v3PackOptions const& options, bool duosFirst, int32 anchor, uint32 window, bool& placedDuo);
+
+// Tries the anchors oldest first until a match forms. windowFn(group) returns the MMR window of an anchor.
+// On success the groups with Result == SOLO_PACK_SELECTED make the match, Side is their team.
+template<class WindowFn>
+bool Solo3v3FindMatch(std::vector<Solo3v3PackGroup>& groups, Solo3v3PackOptions const& options, WindowFn&& windowFn)
+{
+    bool placedDuo = false;
+
+    if (!options.UseWindow)
+    {
+        if (Solo3v3PackTeams(groups, options, options.AllowDuos, -1, 0, placedDuo))
+            return true;
+
+        // The placed duos could not be completed, the solos get a turn on their own
+        return placedDuo && Solo3v3PackTeams(groups, options, false, -1, 0, placedDuo);
+    }
+
+    uint32 tried = 0;
+    for (uint32 anchor = 0; anchor < groups.size(); anchor++)
+    {
+        if (options.MaxAnchors && tried++ >= options.MaxAnchors)
+            break;
+
+        uint32 window = windowFn(groups[anchor]);
+
+        if (Solo3v3PackTeams(groups, options, options.AllowDuos, int32(anchor), window, placedDuo))
+            return true;
+
+        if (placedDuo && groups[anchor].Size == 1 && Solo3v3PackTeams(groups, options, false, int32(anchor), window, placedDuo))
+            return true;
+    }
+
+    return false;
+}
+
+// A group of a finished selection, as the invariant check sees it
+struct Solo3v3SelectedGroup
+{
+    uint64 Key = 0;                                     // identity of the queue entry
+    uint8 Side = 0;                                     // team it was selected for
+    uint8 ListSide = SOLO_PACK_SIDES;                   // queue list it sits in, SOLO_PACK_SIDES = none
+    bool Invited = false;                               // already invited to an instance
+    uint8 Size = 0;
+    uint64 Players[2] = { };
+    uint8 Roles[2] = { };
+    bool Queued[2] = { };                               // player still waiting in the solo queue
+};
+
+enum Solo3v3SelectionError : uint8
+{
+    SOLO_SELECTION_OK = 0,
+    SOLO_SELECTION_TOO_MANY_GROUPS,
+    SOLO_SELECTION_GROUP_TWICE,
+    SOLO_SELECTION_PLAYER_TWICE,
+    SOLO_SELECTION_INVITED,
+    SOLO_SELECTION_WRONG_LIST,
+    SOLO_SELECTION_NOT_QUEUED,
+    SOLO_SELECTION_ROLE_TWICE,
+    SOLO_SELECTION_TEAM_SIZE
+};
+
+struct Solo3v3SelectionCheck
+{
+    Solo3v3SelectionError Error = SOLO_SELECTION_OK;
+    uint32 Group = 0;                                   // index of the group the error was found at
+};
+
+// Every group once, every player once and still queued, groups in the list of their team, not
+// invited elsewhere, three players and (filterTalents) three roles per team
+Solo3v3SelectionCheck Solo3v3CheckSelection(Solo3v3SelectedGroup const* groups, uint32 count, bool filterTalents);
+char const* Solo3v3SelectionErrorText(Solo3v3SelectionError error);
+
+#endif // _SOLO_3V3_PACK_H_
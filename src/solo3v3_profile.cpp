@@ -0,0 +1,115 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_profile.h"
+#include "Chat.h"
+#include "Config.h"
+#include "GameTime.h"
+#include "Log.h"
+#include <cstring>
+#include <fstream>
+
+Solo3v3Profiler* Solo3v3Profiler::instance()
+{
+    static Solo3v3Profiler instance;
+    return &instance;
+}
+
+void Solo3v3Profiler::LoadConfig()
+{
+    enabled = sConfigMgr->GetOption<bool>("Solo.3v3.Profiler.Enable", false);
+}
+
+uint32 Solo3v3Profiler::Enter(char const* name)
+{
+    for (uint32 child : nodes[current].Children)
+    {
+        if (nodes[child].Name == name || !strcmp(nodes[child].Name, name))
+        {
+            current = child;
+            return child;
+        }
+    }
+
+    uint32 child = uint32(nodes.size());
+    nodes.push_back(Node{ name, current, { }, 0, 0, 0 });
+    nodes[current].Children.push_back(child);
+
+    current = child;
+    return child;
+}
+
+void Solo3v3Profiler::Leave(uint32 node, uint64 elapsedNs)
+{
+    Node& left = nodes[node];
+    left.Calls++;
+    left.InclusiveNs += elapsedNs;
+
+    current = left.Parent;
+    nodes[current].ChildNs += elapsedNs;
+}
+
+void Solo3v3Profiler::Reset()
+{
+    for (Node& node : nodes)
+    {
+        node.Calls = 0;
+        node.InclusiveNs = 0;
+        node.ChildNs = 0;
+    }
+}
+
+bool Solo3v3Profiler::Dump(ChatHandler* handler, std::string& fileName) const
+{
+    std::string directory = sConfigMgr->GetOption<std::string>("Solo.3v3.DumpDirectory", "");
+    if (!directory.empty() && directory.back() != '/' && directory.back() != '\\')
+        directory += '/';
+
+    fileName = directory + "soloq_profile_" + std::to_string(GameTime::GetGameTime().count()) + ".folded";
+
+    std::ofstream out(fileName, std::ios::out | std::ios::trunc);
+    if (!out)
+    {
+        LOG_ERROR("module", "Solo3v3: could not open {} for the profile dump", fileName);
+        return false;
+    }
+
+    // Depth first, children right after their parent so the chat output reads like a tree
+    std::vector<std::pair<uint32, std::string>> stack;
+    for (auto itr = nodes[0].Children.rbegin(); itr != nodes[0].Children.rend(); ++itr)
+        stack.emplace_back(*itr, nodes[*itr].Name);
+
+    while (!stack.empty())
+    {
+        auto [index, path] = std::move(stack.back());
+        stack.pop_back();
+
+        Node const& node = nodes[index];
+        uint64 exclusiveNs = node.InclusiveNs > node.ChildNs ? node.InclusiveNs - node.ChildNs : 0;
+
+        if (node.Calls)
+        {
+            out << path << ' ' << exclusiveNs / 1000 << '\n';
+            handler->PSendSysMessage("%s: %u calls, inclusive %u us, exclusive %u us", path.c_str(), uint32(node.Calls), uint32(node.InclusiveNs / 1000), uint32(exclusiveNs / 1000));
+        }
+
+        for (auto itr = node.Children.rbegin(); itr != node.Children.rend(); ++itr)
+            stack.emplace_back(*itr, path + ';' + nodes[*itr].Name);
+    }
+
+    return true;
+}
@@ -0,0 +1,103 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_PROFILE_H_
+#define _SOLO_3V3_PROFILE_H_
+
+#include "Common.h"
+#include <chrono>
+#include <thread>
+
+class ChatHandler;
+
+/*
+ * Scoped profiler of the module functions, Solo.3v3.Profiler.Enable.
+ *
+ * Every SOLO_3V3_PROFILE_SCOPE adds its time to a node of a call tree, so the same function called
+ * from two places shows up under two paths. Only the world thread is profiled, scopes entered on
+ * other threads (map updates) are ignored. .soloq profile dump writes the tree as folded stacks
+ * (path;to;function <exclusive microseconds>) for flamegraph.pl and similar tools.
+ */
+class Solo3v3Profiler
+{
+public:
+    static Solo3v3Profiler* instance();
+
+    void LoadConfig();
+    // Profiled thread, called on startup from the world thread
+    void BindThread() { thread = std::this_thread::get_id(); }
+
+    bool IsActive() const { return enabled && std::this_thread::get_id() == thread; }
+
+    uint32 Enter(char const* name);
+    void Leave(uint32 node, uint64 elapsedNs);
+
+    // Clears the counters, the tree itself is kept for the scopes still open
+    void Reset();
+
+    // Writes the folded stacks into fileName (in Solo.3v3.DumpDirectory) and prints the tree
+    bool Dump(ChatHandler* handler, std::string& fileName) const;
+
+private:
+    struct Node
+    {
+        char const* Name;
+        uint32 Parent;
+        std::vector<uint32> Children;
+        uint64 Calls;
+        uint64 InclusiveNs;
+        uint64 ChildNs;
+    };
+
+    bool enabled = false;
+    std::thread::id thread;
+
+    std::vector<Node> nodes{ Node{ "", 0, { }, 0, 0, 0 } };    // [0] = root
+    uint32 current = 0;
+};
+
+#define sSoloProfiler Solo3v3Profiler::instance()
+
+class Solo3v3ProfileScope
+{
+public:
+    explicit Solo3v3ProfileScope(char const* name)
+    {
+        if (!sSoloProfiler->IsActive())
+            return;
+
+        node = sSoloProfiler->Enter(name);
+        start = std::chrono::steady_clock::now();
+    }
+
+    ~Solo3v3ProfileScope()
+    {
+        if (node)
+            sSoloProfiler->Leave(node, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    Solo3v3ProfileScope(Solo3v3ProfileScope const&) = delete;
+    Solo3v3ProfileScope& operator=(Solo3v3ProfileScope const&) = delete;
+
+private:
+    uint32 node = 0;
+    std::chrono::steady_clock::time_point start;
+};
+
+#define SOLO_3V3_PROFILE_SCOPE(name) Solo3v3ProfileScope const soloProfileScope(name)
+
+#endif // _SOLO_3V3_PROFILE_H_
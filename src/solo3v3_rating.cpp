@@ -0,0 +1,153 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_rating.h"
+#include "solo3v3_forecast.h"
+#include "solo3v3_memory.h"
+#include "ArenaTeamMgr.h"
+#include "Config.h"
+#include "Log.h"
+#include "Timer.h"
+#include <algorithm>
+
+void Solo3v3RatingHistogram::Add(uint32 mmr)
+{
+    buckets[GetBucket(mmr)]++;
+    total++;
+}
+
+void Solo3v3RatingHistogram::Remove(uint32 mmr)
+{
+    uint32& count = buckets[GetBucket(mmr)];
+    if (!count)
+        return;
+
+    count--;
+    total--;
+}
+
+void Solo3v3RatingHistogram::Clear()
+{
+    memset(buckets, 0, sizeof(buckets));
+    total = 0;
+}
+
+uint32 Solo3v3RatingHistogram::GetRadius(uint32 mmr, uint32 count, uint32 maxDistance) const
+{
+    if (total < count)
+        return maxDistance;
+
+    // Grow one bucket to each side per step, bounded by the bucket count and not by the players
+    int32 center = int32(GetBucket(mmr));
+    uint32 covered = 0;
+
+    for (int32 distance = 0; distance < int32(SOLO_RATING_BUCKETS); distance++)
+    {
+        uint32 radius = (distance + 1) * SOLO_RATING_BUCKET_SIZE;
+        if (radius >= maxDistance)
+            return maxDistance;
+
+        if (center - distance >= 0)
+            covered += buckets[center - distance];
+
+        if (distance && center + distance < int32(SOLO_RATING_BUCKETS))
+            covered += buckets[center + distance];
+
+        if (covered >= count)
+            return radius;
+    }
+
+    return maxDistance;
+}
+
+Solo3v3RatingDistribution* Solo3v3RatingDistribution::instance()
+{
+    static Solo3v3RatingDistribution instance;
+    return &instance;
+}
+
+void Solo3v3RatingDistribution::LoadConfig()
+{
+    enabled = sConfigMgr->GetOption<bool>("Solo.3v3.MatchWindow.Enable", false);
+    nearest = sConfigMgr->GetOption<uint32>("Solo.3v3.MatchWindow.Nearest", 5);
+    ladderPercent = sConfigMgr->GetOption<float>("Solo.3v3.MatchWindow.LadderPercent", 2.0f);
+    minWindow = sConfigMgr->GetOption<uint32>("Solo.3v3.MatchWindow.Min", 100);
+    maxWindow = std::max(minWindow, sConfigMgr->GetOption<uint32>("Solo.3v3.MatchWindow.Max", 1000));
+    // Every anchor is a full pack pass, trying all of them would make each queue update quadratic
+    anchors = std::clamp<uint32>(sConfigMgr->GetOption<uint32>("Solo.3v3.MatchWindow.Anchors", 4), 1, SOLO_RATING_MAX_ANCHORS);
+    widenPerMinute = sConfigMgr->GetOption<uint32>("Solo.3v3.MatchWindow.WidenPerMinute", 50);
+}
+
+void Solo3v3RatingDistribution::LoadLadder()
+{
+    uint32 oldMSTime = getMSTime();
+
+    ladder.Clear();
+    ladderRatings.clear();
+
+    for (auto const& itr : sArenaTeamMgr->GetArenaTeams())
+    {
+        ArenaTeam* team = itr.second;
+        if (team->GetType() != ARENA_TEAM_SOLO_3v3)
+            continue;
+
+        if (ArenaTeamMember* member = team->GetMember(team->GetCaptain()))
+            OnRatingChange(member->Guid, member->MatchMakerRating);
+    }
+
+    LOG_INFO("module", ">> Loaded the solo 3v3 ladder distribution of {} players in {} ms", ladder.GetTotal(), GetMSTimeDiffToNow(oldMSTime));
+}
+
+void Solo3v3RatingDistribution::ClearQueued()
+{
+    for (Solo3v3RatingHistogram& histogram : queued)
+        histogram.Clear();
+}
+
+void Solo3v3RatingDistribution::OnRatingChange(ObjectGuid guid, uint32 mmr)
+{
+    auto result = ladderRatings.emplace(guid.GetCounter(), mmr);
+    if (!result.second)
+    {
+        ladder.Remove(result.first->second);
+        result.first->second = mmr;
+    }
+
+    ladder.Add(mmr);
+}
+
+uint32 Solo3v3RatingDistribution::GetMatchWindow(BattlegroundBracketId bracket_id, uint32 mmr, uint32 waited) const
+{
+    // The player itself is queued too
+    uint32 window = queued[bracket_id].GetRadius(mmr, nearest + 1, maxWindow);
+
+    if (uint32 ladderCount = uint32(ladder.GetTotal() * ladderPercent / 100.0f))
+        window = std::max(window, ladder.GetRadius(mmr, ladderCount, maxWindow));
+
+    // Quiet hours start wider, fewer players will join to fill a narrow window
+    window = std::clamp(window, sSoloForecast->GetWindowFloor(bracket_id, minWindow, maxWindow), maxWindow);
+
+    // Nobody waits forever for the perfect match
+    uint64 widened = window + uint64(widenPerMinute) * waited / (MINUTE * IN_MILLISECONDS);
+    return uint32(std::min<uint64>(widened, maxWindow));
+}
+
+void Solo3v3RatingDistribution::ReportMemory(Solo3v3MemoryReport& report) const
+{
+    report.Add("rating histograms", sizeof(queued) + sizeof(ladder), MAX_BATTLEGROUND_BRACKETS + 1);
+    report.Add("ladder ratings", Solo3v3HashBytes(ladderRatings), ladderRatings.size());
+}
@@ -0,0 +1,103 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_RATING_H_
+#define _SOLO_3V3_RATING_H_
+
+#include "solo3v3.h"
+
+constexpr uint32 SOLO_RATING_BUCKET_SIZE = 25;
+constexpr uint32 SOLO_RATING_BUCKETS = 160;        // 0 - 3999, higher ratings land in the last bucket
+constexpr uint32 SOLO_RATING_MAX_ANCHORS = 16;     // anchors tried per queue update, each is a full pack pass
+
+// Count of players per MMR bucket
+class Solo3v3RatingHistogram
+{
+public:
+    static uint32 GetBucket(uint32 mmr) { return std::min(mmr / SOLO_RATING_BUCKET_SIZE, SOLO_RATING_BUCKETS - 1); }
+
+    void Add(uint32 mmr);
+    void Remove(uint32 mmr);
+    void Clear();
+
+    uint32 GetTotal() const { return total; }
+    uint32 GetCount(uint32 bucket) const { return buckets[bucket]; }
+
+    // Smallest MMR distance around mmr covering at least count players, maxDistance when there are fewer
+    uint32 GetRadius(uint32 mmr, uint32 count, uint32 maxDistance) const;
+
+private:
+    uint32 buckets[SOLO_RATING_BUCKETS] = { };
+    uint32 total = 0;
+};
+
+/*
+ * Live MMR distribution of the solo queue (per bracket) and of the whole solo ladder.
+ *
+ * The queue histograms follow the queue mirror of Solo3v3 (join, leave, invite), the ladder one
+ * is built from the solo arena teams at startup and follows every rating change in SaveSoloDB.
+ * The matcher sizes its MMR window from them: wide enough to reach the Nearest closest queued
+ * players and Solo.3v3.MatchWindow.LadderPercent of the ladder, so the window stays narrow where
+ * many players are rated and opens up at both ends of the ladder. It also widens by
+ * Solo.3v3.MatchWindow.WidenPerMinute for every minute the anchor waits, up to the maximum.
+ */
+class Solo3v3RatingDistribution
+{
+public:
+    static Solo3v3RatingDistribution* instance();
+
+    void LoadConfig();
+    // From the arena teams loaded by the core, called on startup
+    void LoadLadder();
+    void ReportMemory(Solo3v3MemoryReport& report) const;
+
+    bool IsEnabled() const { return enabled; }
+    uint32 GetNearest() const { return nearest; }
+    float GetLadderPercent() const { return ladderPercent; }
+    uint32 GetMinWindow() const { return minWindow; }
+    uint32 GetMaxWindow() const { return maxWindow; }
+    uint32 GetAnchors() const { return anchors; }
+    uint32 GetWidenPerMinute() const { return widenPerMinute; }
+
+    void OnQueueJoin(BattlegroundBracketId bracket_id, uint32 mmr) { queued[bracket_id].Add(mmr); }
+    void OnQueueLeave(BattlegroundBracketId bracket_id, uint32 mmr) { queued[bracket_id].Remove(mmr); }
+    void ClearQueued();
+    void OnRatingChange(ObjectGuid guid, uint32 mmr);
+
+    // Largest MMR difference to mmr the matcher accepts in a match of the bracket, for an anchor queued waited ms
+    uint32 GetMatchWindow(BattlegroundBracketId bracket_id, uint32 mmr, uint32 waited) const;
+
+    Solo3v3RatingHistogram const& GetQueued(BattlegroundBracketId bracket_id) const { return queued[bracket_id]; }
+    Solo3v3RatingHistogram const& GetLadder() const { return ladder; }
+
+private:
+    bool enabled = false;
+    uint32 nearest = 5;
+    float ladderPercent = 2.0f;
+    uint32 minWindow = 100;
+    uint32 maxWindow = 1000;
+    uint32 anchors = 4;
+    uint32 widenPerMinute = 50;
+
+    Solo3v3RatingHistogram queued[MAX_BATTLEGROUND_BRACKETS];
+    Solo3v3RatingHistogram ladder;
+    std::unordered_map<ObjectGuid::LowType, uint32> ladderRatings;
+};
+
+#define sSoloRating Solo3v3RatingDistribution::instance()
+
+#endif // _SOLO_3V3_RATING_H_
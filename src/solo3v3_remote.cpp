@@ -0,0 +1,471 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_remote.h"
+#include "solo3v3_memory.h"
+#include "Config.h"
+#include "GameTime.h"
+#include "Log.h"
+
+#if AC_PLATFORM != AC_PLATFORM_WINDOWS
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+constexpr size_t SOLO_REMOTE_MAX_SEND_BUFFER = 1024 * 1024;    // daemon is stalled when this much is pending
+constexpr size_t SOLO_REMOTE_MAX_RECORD_SIZE = 4096;
+constexpr size_t SOLO_REMOTE_MAX_PROPOSALS = 64;
+
+Solo3v3RemoteMatcher* Solo3v3RemoteMatcher::instance()
+{
+    static Solo3v3RemoteMatcher instance;
+    return &instance;
+}
+
+void Solo3v3RemoteMatcher::LoadConfig()
+{
+    std::string oldPath = socketPath;
+
+    enabled = sConfigMgr->GetOption<bool>("Solo.3v3.Remote.Enable", false);
+    socketPath = sConfigMgr->GetOption<std::string>("Solo.3v3.Remote.SocketPath", "/tmp/solo3v3_matcher.sock");
+    realmId = sConfigMgr->GetOption<uint32>("Solo.3v3.Remote.RealmId", 1);
+    retryInterval = sConfigMgr->GetOption<uint32>("Solo.3v3.Remote.RetryInterval", 5) * IN_MILLISECONDS;
+    timeout = sConfigMgr->GetOption<uint32>("Solo.3v3.Remote.Timeout", 30) * IN_MILLISECONDS;
+
+#if AC_PLATFORM == AC_PLATFORM_WINDOWS
+    if (enabled)
+    {
+        LOG_ERROR("module", "Solo3v3: Solo.3v3.Remote.Enable needs Unix domain sockets, using the in-process matcher");
+        enabled = false;
+    }
+#endif
+
+    if (socketFd >= 0 && (!enabled || oldPath != socketPath))
+        Disconnect();
+
+    retryTimer = 0;
+}
+
+void Solo3v3RemoteMatcher::Update(uint32 diff)
+{
+    if (!enabled)
+        return;
+
+    if (socketFd < 0)
+    {
+        if (retryTimer > diff)
+        {
+            retryTimer -= diff;
+            return;
+        }
+
+        retryTimer = retryInterval;
+
+        if (!Connect())
+            return;
+    }
+
+    if (connecting && !FinishConnect())
+        return;
+
+    Flush();
+    Receive();
+}
+
+bool Solo3v3RemoteMatcher::IsIdle(BattlegroundBracketId bracket_id) const
+{
+    return IsConnected() && timeout && getMSTimeDiff(lastProposal[bracket_id], GameTime::GetGameTimeMS().count()) > timeout;
+}
+
+void Solo3v3RemoteMatcher::OnConnected()
+{
+    connecting = false;
+
+    uint32 now = GameTime::GetGameTimeMS().count();
+    for (uint32& time : lastProposal)
+        time = now;
+
+    connected.store(true, std::memory_order_release);
+    LOG_INFO("module", "Solo3v3: connected to remote matcher at {}", socketPath);
+
+    uint8 hello[SOLO_WIRE_HELLO_SIZE];
+    Solo3v3Wire::EncodeHello(hello, realmId);
+    Queue(hello, sizeof(hello));
+
+    // The daemon knows nothing about this realm yet
+    SendQueueState();
+}
+
+#if AC_PLATFORM != AC_PLATFORM_WINDOWS
+
+bool Solo3v3RemoteMatcher::Connect()
+{
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+
+    if (socketPath.size() >= sizeof(addr.sun_path))
+    {
+        LOG_ERROR("module", "Solo3v3: Solo.3v3.Remote.SocketPath is too long");
+        enabled = false;
+        return false;
+    }
+
+    memcpy(addr.sun_path, socketPath.c_str(), socketPath.size());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return false;
+
+    // Non-blocking before connecting, a daemon with a full backlog must not stall the world thread
+    if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK) != 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    socketFd = fd;
+
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+    {
+        if (errno != EINPROGRESS)
+        {
+            Disconnect();
+            return false;
+        }
+
+        // finished by FinishConnect on a later update
+        connecting = true;
+        return true;
+    }
+
+    OnConnected();
+    return true;
+}
+
+bool Solo3v3RemoteMatcher::FinishConnect()
+{
+    pollfd pfd = { socketFd, POLLOUT, 0 };
+    if (poll(&pfd, 1, 0) == 0)
+        return false;
+
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (getsockopt(socketFd, SOL_SOCKET, SO_ERROR, &error, &length) != 0 || error != 0)
+    {
+        Disconnect();
+        return false;
+    }
+
+    OnConnected();
+    return true;
+}
+
+void Solo3v3RemoteMatcher::Disconnect()
+{
+    if (socketFd >= 0)
+    {
+        close(socketFd);
+
+        if (IsConnected())
+            LOG_INFO("module", "Solo3v3: disconnected from remote matcher, falling back to the in-process matcher");
+    }
+
+    socketFd = -1;
+    connecting = false;
+    connected.store(false, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(sendLock);
+        sendBuffer.clear();
+        stalled = false;
+    }
+
+    recvBuffer.clear();
+    proposals.clear();
+}
+
+void Solo3v3RemoteMatcher::Flush()
+{
+    std::unique_lock<std::mutex> lock(sendLock);
+
+    if (stalled)
+    {
+        lock.unlock();
+        LOG_ERROR("module", "Solo3v3: remote matcher does not read its events");
+        Disconnect();
+        return;
+    }
+
+    size_t sent = 0;
+
+    while (sent < sendBuffer.size())
+    {
+        ssize_t result = send(socketFd, sendBuffer.data() + sent, sendBuffer.size() - sent, MSG_NOSIGNAL);
+        if (result < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                break;
+
+            lock.unlock();
+            Disconnect();
+            return;
+        }
+
+        sent += size_t(result);
+    }
+
+    sendBuffer.erase(sendBuffer.begin(), sendBuffer.begin() + sent);
+}
+
+void Solo3v3RemoteMatcher::Receive()
+{
+    uint8 chunk[4096];
+
+    while (IsConnected())
+    {
+        ssize_t result = recv(socketFd, chunk, sizeof(chunk), 0);
+        if (result < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                break;
+
+            Disconnect();
+            return;
+        }
+
+        if (result == 0)
+        {
+            Disconnect();
+            return;
+        }
+
+        recvBuffer.insert(recvBuffer.end(), chunk, chunk + result);
+    }
+
+    size_t offset = 0;
+
+    // Records are read in place from the receive buffer
+    while (true)
+    {
+        Solo3v3Wire::RecordView record(recvBuffer.data() + offset, recvBuffer.size() - offset);
+        if (!record.HasHeader())
+            break;
+
+        if (!record.IsWellFormed() || record.Size() > SOLO_REMOTE_MAX_RECORD_SIZE)
+        {
+            LOG_ERROR("module", "Solo3v3: malformed record from remote matcher (version {}, type {}, size {})", record.Version(), record.Type(), record.Size());
+            Disconnect();
+            return;
+        }
+
+        if (!record.IsComplete())
+            break;
+
+        if (record.Type() == SOLO_WIRE_PROPOSAL && record.RealmId() == realmId && record.ProposalBracket() < MAX_BATTLEGROUND_BRACKETS
+            && proposals.size() < SOLO_REMOTE_MAX_PROPOSALS)
+        {
+            Proposal proposal;
+            proposal.Bracket = BattlegroundBracketId(record.ProposalBracket());
+            for (uint32 i = 0; i < SOLO_WIRE_MATCH_SIZE; i++)
+                proposal.Guids[i] = record.ProposalGuid(i);
+
+            proposals.push_back(proposal);
+            lastProposal[proposal.Bracket] = GameTime::GetGameTimeMS().count();
+        }
+
+        offset += record.Size();
+    }
+
+    recvBuffer.erase(recvBuffer.begin(), recvBuffer.begin() + offset);
+}
+
+#else
+
+bool Solo3v3RemoteMatcher::Connect() { return false; }
+bool Solo3v3RemoteMatcher::FinishConnect() { return false; }
+void Solo3v3RemoteMatcher::Disconnect() { }
+void Solo3v3RemoteMatcher::Flush() { }
+void Solo3v3RemoteMatcher::Receive() { }
+
+#endif
+
+void Solo3v3RemoteMatcher::Queue(uint8 const* record, size_t size)
+{
+    if (!IsConnected())
+        return;
+
+    std::lock_guard<std::mutex> lock(sendLock);
+
+    // The socket is only touched by the world thread, the next Flush disconnects
+    if (stalled || sendBuffer.size() + size > SOLO_REMOTE_MAX_SEND_BUFFER)
+    {
+        stalled = true;
+        return;
+    }
+
+    sendBuffer.insert(sendBuffer.end(), record, record + size);
+}
+
+void Solo3v3RemoteMatcher::SendQueueState()
+{
+    BattlegroundQueue& queue = sBattlegroundMgr->GetBattlegroundQueue(bgQueueTypeId);
+
+    for (int bracket = BG_BRACKET_ID_FIRST; bracket <= BG_BRACKET_ID_LAST; bracket++)
+    {
+        for (int teamId = 0; teamId < BG_TEAMS_COUNT; teamId++)
+        {
+            for (auto const& ginfo : queue.m_QueuedGroups[bracket][teamId])
+            {
+                if (ginfo->ArenaType != ARENA_TYPE_3v3_SOLO || ginfo->IsInvitedToBGInstanceGUID)
+                    continue;
+
+                for (auto const& playerGuid : ginfo->Players)
+                    if (Player* plr = ObjectAccessor::FindPlayer(playerGuid))
+                        SendJoin(playerGuid, BattlegroundBracketId(bracket), sSolo->GetCachedTalentCatForSolo3v3(plr), ginfo->ArenaMatchmakerRating, uint8(ginfo->Players.size()));
+            }
+        }
+    }
+}
+
+void Solo3v3RemoteMatcher::SendJoin(ObjectGuid guid, BattlegroundBracketId bracket_id, Solo3v3TalentCat role, uint32 mmr, uint8 groupSize)
+{
+    uint8 record[SOLO_WIRE_JOIN_SIZE];
+    Solo3v3Wire::EncodeJoin(record, realmId, guid.GetCounter(), mmr, uint8(bracket_id), uint8(role), groupSize);
+    Queue(record, sizeof(record));
+}
+
+void Solo3v3RemoteMatcher::SendLeave(ObjectGuid guid, BattlegroundBracketId bracket_id)
+{
+    uint8 record[SOLO_WIRE_LEAVE_SIZE];
+    Solo3v3Wire::EncodeLeave(record, realmId, guid.GetCounter(), uint8(bracket_id));
+    Queue(record, sizeof(record));
+}
+
+void Solo3v3RemoteMatcher::SendRating(ObjectGuid guid, uint32 mmr)
+{
+    uint8 record[SOLO_WIRE_RATING_SIZE];
+    Solo3v3Wire::EncodeRating(record, realmId, guid.GetCounter(), mmr);
+    Queue(record, sizeof(record));
+}
+
+void Solo3v3RemoteMatcher::SendResult(Solo3v3ArenaInfo const& info, TeamId winner)
+{
+    if (!IsConnected())
+        return;
+
+    uint32 guids[SOLO_WIRE_MATCH_SIZE] = { };
+    for (uint32 team = 0; team < BG_TEAMS_COUNT; team++)
+        for (uint32 slot = 0; slot < info.PlayerCount[team]; slot++)
+            guids[team * 3 + slot] = info.Players[team][slot].GetCounter();
+
+    uint8 record[SOLO_WIRE_RESULT_SIZE];
+    Solo3v3Wire::EncodeResult(record, realmId, info.InstanceId, uint8(info.BracketId), uint8(winner), guids);
+    Queue(record, sizeof(record));
+}
+
+static GroupQueueInfo* FindQueuedSoloGroup(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, ObjectGuid::LowType guid)
+{
+    for (int teamId = 0; teamId < BG_TEAMS_COUNT; teamId++)
+        for (auto const& ginfo : queue->m_QueuedGroups[bracket_id][teamId])
+            for (auto const& playerGuid : ginfo->Players)
+                if (playerGuid.GetCounter() == guid)
+                    return ginfo;
+
+    return nullptr;
+}
+
+bool Solo3v3RemoteMatcher::ApplyProposal(BattlegroundQueue* queue, BattlegroundBracketId bracket_id)
+{
+    for (auto itr = proposals.begin(); itr != proposals.end();)
+    {
+        if (itr->Bracket != bracket_id)
+        {
+            ++itr;
+            continue;
+        }
+
+        Proposal proposal = *itr;
+        itr = proposals.erase(itr);
+
+        queue->m_SelectionPools[TEAM_ALLIANCE].Init();
+        queue->m_SelectionPools[TEAM_HORDE].Init();
+
+        GroupQueueInfo* groups[SOLO_WIRE_MATCH_SIZE];
+        bool valid = true;
+
+        for (uint32 i = 0; i < SOLO_WIRE_MATCH_SIZE; i++)
+        {
+            groups[i] = FindQueuedSoloGroup(queue, bracket_id, proposal.Guids[i]);
+
+            // Both players of a duo are listed, the group is added once and must stay on one side
+            uint32 mate = 0;
+            while (mate < i && (!groups[i] || groups[mate] != groups[i]))
+                mate++;
+
+            if (mate < i)
+            {
+                if (mate / 3 != i / 3)
+                {
+                    valid = false;
+                    break;
+                }
+
+                continue;
+            }
+
+            // Left the queue or got matched meanwhile, tell the daemon so it drops the player as well
+            if (!groups[i] || groups[i]->IsInvitedToBGInstanceGUID || groups[i]->ArenaType != ARENA_TYPE_3v3_SOLO
+                || !queue->m_SelectionPools[i / 3].AddGroup(groups[i], 3))
+            {
+                if (!groups[i])
+                    SendLeave(ObjectGuid::Create<HighGuid::Player>(proposal.Guids[i]), bracket_id);
+
+                valid = false;
+                break;
+            }
+        }
+
+        if (!valid)
+            continue;
+
+        // Same faction swap as CheckSolo3v3Arena, so InviteGroupToBG finds each group in the list of its side
+        for (uint32 i = 0; i < SOLO_WIRE_MATCH_SIZE; i++)
+            sSolo->MoveQueuedGroupToTeam(queue, bracket_id, groups[i], TeamId(i / 3));
+
+        return true;
+    }
+
+    queue->m_SelectionPools[TEAM_ALLIANCE].Init();
+    queue->m_SelectionPools[TEAM_HORDE].Init();
+    return false;
+}
+
+void Solo3v3RemoteMatcher::ReportMemory(Solo3v3MemoryReport& report) const
+{
+    std::lock_guard<std::mutex> lock(sendLock);
+    report.Add("remote buffers", Solo3v3VectorBytes(sendBuffer) + Solo3v3VectorBytes(recvBuffer) + Solo3v3VectorBytes(proposals), proposals.size());
+}
@@ -0,0 +1,97 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_REMOTE_H_
+#define _SOLO_3V3_REMOTE_H_
+
+#include "solo3v3.h"
+#include "solo3v3_wire.h"
+
+/*
+ * Client for an out-of-process solo matcher listening on a local Unix socket.
+ *
+ * Every worldserver streams join/leave/rating events of its solo queue to the daemon and gets
+ * match proposals back (6 guids, first 3 alliance side), see solo3v3_wire.h for the records.
+ * Several realms on one host can share a daemon, records carry Solo.3v3.Remote.RealmId so the
+ * daemon keeps the pools apart or joins them.
+ * As long as the daemon is not connected the in-process CheckSolo3v3Arena is used, and also for a
+ * bracket the daemon sent no proposal for in Solo.3v3.Remote.Timeout.
+ *
+ * The socket, the receive side and the proposals belong to the world thread. The Send* functions
+ * may be called from map threads, they only append to the send buffer under sendLock.
+ */
+
+class Solo3v3RemoteMatcher
+{
+public:
+    static Solo3v3RemoteMatcher* instance();
+
+    void LoadConfig();
+    void Update(uint32 diff);
+    void Disconnect();
+    void ReportMemory(Solo3v3MemoryReport& report) const;
+
+    bool IsConnected() const { return connected.load(std::memory_order_acquire); }
+    // Connected, but no proposal for the bracket since Solo.3v3.Remote.Timeout
+    bool IsIdle(BattlegroundBracketId bracket_id) const;
+
+    void SendJoin(ObjectGuid guid, BattlegroundBracketId bracket_id, Solo3v3TalentCat role, uint32 mmr, uint8 groupSize);
+    void SendLeave(ObjectGuid guid, BattlegroundBracketId bracket_id);
+    void SendRating(ObjectGuid guid, uint32 mmr);
+    void SendResult(Solo3v3ArenaInfo const& info, TeamId winner);
+
+    // Fills the selection pools from the oldest proposal of that bracket whose players are all still queued
+    bool ApplyProposal(BattlegroundQueue* queue, BattlegroundBracketId bracket_id);
+
+private:
+    struct Proposal
+    {
+        BattlegroundBracketId Bracket;
+        ObjectGuid::LowType Guids[SOLO_WIRE_MATCH_SIZE];
+    };
+
+    bool Connect();
+    // Non-blocking connect in progress, true once it went through
+    bool FinishConnect();
+    void OnConnected();
+    void SendQueueState();
+    // Appends one encoded record to the send buffer, dropped when disconnected
+    void Queue(uint8 const* record, size_t size);
+    void Flush();
+    void Receive();
+
+    bool enabled = false;
+    std::string socketPath;
+    uint32 realmId = 0;
+    uint32 retryInterval = 5000;
+    uint32 retryTimer = 0;
+    uint32 timeout = 30000;
+
+    int socketFd = -1;
+    bool connecting = false;
+    std::atomic<bool> connected{ false };
+    mutable std::mutex sendLock;                // guards sendBuffer and stalled
+    std::vector<uint8> sendBuffer;
+    bool stalled = false;                       // send buffer overflowed, disconnected on the next update
+    uint32 lastProposal[MAX_BATTLEGROUND_BRACKETS] = { };   // GameTime ms, or of the connect
+    std::vector<uint8> recvBuffer;
+    std::vector<Proposal> proposals;
+};
+
+#define sSoloRemote Solo3v3RemoteMatcher::instance()
+
+#endif // _SOLO_3V3_REMOTE_H_
@@ -0,0 +1,109 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_roles.h"
+#include "solo3v3_memory.h"
+#include "DatabaseEnv.h"
+#include "Log.h"
+#include "Timer.h"
+
+// TalentTab.dbc ids stay far below this, anything above is a typo in the table
+constexpr uint32 SOLO_ROLES_MAX_TALENT_TAB = 1024;
+
+void Solo3v3RoleTable::SetRole(uint32 talentTab, Solo3v3TalentCat role)
+{
+    if (talentTab >= roles.size())
+        roles.resize(talentTab + 1, NO_ROLE);
+
+    roles[talentTab] = int8(role);
+}
+
+Solo3v3RoleMap* Solo3v3RoleMap::instance()
+{
+    static Solo3v3RoleMap instance;
+    return &instance;
+}
+
+uint32 Solo3v3RoleMap::Load()
+{
+    uint32 oldMSTime = getMSTime();
+
+    auto table = std::make_shared<Solo3v3RoleTable>();
+    uint32 count = 0;
+
+    if (QueryResult result = WorldDatabase.Query("SELECT `talent_tab`, `role` FROM `solo_3v3_talent_role`"))
+    {
+        do
+        {
+            Field* fields = result->Fetch();
+            uint32 talentTab = fields[0].Get<uint32>();
+            uint8 role = fields[1].Get<uint8>();
+
+            if (talentTab >= SOLO_ROLES_MAX_TALENT_TAB || role >= MAX_TALENT_CAT)
+            {
+                LOG_ERROR("sql.sql", "Table `solo_3v3_talent_role` has invalid talent tab {} or role {}, skipped.", talentTab, role);
+                continue;
+            }
+
+            table->SetRole(talentTab, Solo3v3TalentCat(role));
+            count++;
+        } while (result->NextRow());
+    }
+
+    if (!count)
+    {
+        for (int8 i = 0; SOLO_3V3_TALENTS_MELEE[i] != 0; i++)
+            table->SetRole(SOLO_3V3_TALENTS_MELEE[i], MELEE);
+
+        for (int8 i = 0; SOLO_3V3_TALENTS_RANGE[i] != 0; i++)
+            table->SetRole(SOLO_3V3_TALENTS_RANGE[i], RANGE);
+
+        for (int8 i = 0; SOLO_3V3_TALENTS_HEAL[i] != 0; i++)
+            table->SetRole(SOLO_3V3_TALENTS_HEAL[i], HEALER);
+
+        LOG_INFO("module", ">> Table `solo_3v3_talent_role` is empty, using the built-in solo 3v3 talent roles");
+    }
+
+    // Roles cached for players are only stale when a tab got another role
+    std::shared_ptr<Solo3v3RoleTable const> old = GetTable();
+    bool changed = !old;
+
+    if (old)
+        for (uint32 talentTab = 0; talentTab < std::max(old->Size(), table->Size()) && !changed; talentTab++)
+            changed = old->GetRole(talentTab) != table->GetRole(talentTab);
+
+    // Publish, readers still holding the old table keep it alive until they are done
+    std::atomic_store(&published, std::shared_ptr<Solo3v3RoleTable const>(std::move(table)));
+
+    if (changed && old)
+        sSolo->InvalidateAllTalentCats();
+
+    LOG_INFO("module", ">> Loaded {} solo 3v3 talent roles in {} ms", count, GetMSTimeDiffToNow(oldMSTime));
+    return count;
+}
+
+std::shared_ptr<Solo3v3RoleTable const> Solo3v3RoleMap::GetTable() const
+{
+    return std::atomic_load(&published);
+}
+
+void Solo3v3RoleMap::ReportMemory(Solo3v3MemoryReport& report) const
+{
+    std::shared_ptr<Solo3v3RoleTable const> table = GetTable();
+    size_t size = table ? table->Size() : 0;
+    report.Add("talent role tables", size * sizeof(int8), size);
+}
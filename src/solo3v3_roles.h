@@ -0,0 +1,63 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_ROLES_H_
+#define _SOLO_3V3_ROLES_H_
+
+#include "solo3v3.h"
+#include <memory>
+
+// Role of every talent tab, indexed by TalentTab.dbc id. Never changed once published.
+class Solo3v3RoleTable
+{
+public:
+    static constexpr int8 NO_ROLE = -1;
+
+    int8 GetRole(uint32 talentTab) const { return talentTab < roles.size() ? roles[talentTab] : NO_ROLE; }
+    void SetRole(uint32 talentTab, Solo3v3TalentCat role);
+    size_t Size() const { return roles.size(); }
+
+private:
+    std::vector<int8> roles;
+};
+
+/*
+ * Talent tab -> role mapping, read from the world table solo_3v3_talent_role
+ * (falls back to the SOLO_3V3_TALENTS_* lists when the table is empty).
+ *
+ * Reloading builds a complete new table and swaps it in. Readers copy the shared_ptr with
+ * std::atomic_load and never lock, they see either the old or the new table. The replaced one is
+ * freed when the last reader holding it lets go, however long that takes.
+ */
+class Solo3v3RoleMap
+{
+public:
+    static Solo3v3RoleMap* instance();
+
+    // Returns the number of mapped talent tabs, invalidates the cached roles when a mapping changed
+    uint32 Load();
+    void ReportMemory(Solo3v3MemoryReport& report) const;
+
+    std::shared_ptr<Solo3v3RoleTable const> GetTable() const;
+
+private:
+    std::shared_ptr<Solo3v3RoleTable const> published;  // only accessed through std::atomic_load/atomic_store
+};
+
+#define sSoloRoles Solo3v3RoleMap::instance()
+
+#endif // _SOLO_3V3_ROLES_H_
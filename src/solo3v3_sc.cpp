@@ -27,26 +27,46 @@ void NpcSolo3v3::Initialize()
 
 bool NpcSolo3v3::OnGossipHello(Player* player, Creature* creature)
 {
+    SOLO_3V3_PROFILE_SCOPE("NpcSolo3v3::OnGossipHello");
+
     if (!player || !creature)
         return true;
 
-    if (sConfigMgr->GetOption<bool>("Solo.3v3.Enable", true) == false)
+    Solo3v3Config const& config = sSolo->GetConfig();
+
+    if (!config.Enable)
     {
         ChatHandler(player->GetSession()).SendSysMessage("Arena disabled!");
         return true;
     }
 
     fetchQueueList();
-    std::stringstream infoQueue;
-    infoQueue << "Solo 3vs3 Arena\n";
-    infoQueue << "Queued Players: " << (cache3v3Queue[MELEE] + cache3v3Queue[RANGE] + cache3v3Queue[HEALER]);
 
-    if (sConfigMgr->GetOption<bool>("Solo.3v3.FilterTalents", false))
+    // Formatted into a stack buffer, this is shown on every gossip hello
+    char infoQueue[256];
+    int infoLen = snprintf(infoQueue, sizeof(infoQueue), "Solo 3vs3 Arena\nQueued Players: %d", cache3v3Queue[MELEE] + cache3v3Queue[RANGE] + cache3v3Queue[HEALER]);
+
+    if (config.FilterTalents && infoLen > 0 && infoLen < int(sizeof(infoQueue)))
     {
-        infoQueue << "\n\n";
-        infoQueue << "Queued Melees: " << cache3v3Queue[MELEE] << " (Longer Queues!)" << "\n";
-        infoQueue << "Queued Casters: " << cache3v3Queue[RANGE] << " (Longer Queues!)" << "\n";
-        infoQueue << "Queued Healers: " << cache3v3Queue[HEALER] << " (Bonus Rewards!)" << "\n";
+        Battleground* bg = sBattlegroundMgr->GetBattlegroundTemplate(BATTLEGROUND_AA);
+        PvPDifficultyEntry const* bracketEntry = bg ? GetBattlegroundBracketByLevel(bg->GetMapId(), player->getLevel()) : nullptr;
+
+        if (config.RoleBonusEnable && bracketEntry)
+        {
+            // cached multipliers of the bracket, see Solo3v3::UpdateRoleRewards
+            BattlegroundBracketId bracketId = bracketEntry->GetBracketId();
+            snprintf(infoQueue + infoLen, sizeof(infoQueue) - infoLen,
+                "\n\nQueued Melees: %d (Rewards x%.2f)\nQueued Casters: %d (Rewards x%.2f)\nQueued Healers: %d (Rewards x%.2f)\n",
+                cache3v3Queue[MELEE], sSolo->GetRoleRewardMultiplier(bracketId, MELEE),
+                cache3v3Queue[RANGE], sSolo->GetRoleRewardMultiplier(bracketId, RANGE),
+                cache3v3Queue[HEALER], sSolo->GetRoleRewardMultiplier(bracketId, HEALER));
+        }
+        else
+        {
+            snprintf(infoQueue + infoLen, sizeof(infoQueue) - infoLen,
+                "\n\nQueued Melees: %d (Longer Queues!)\nQueued Casters: %d (Longer Queues!)\nQueued Healers: %d (Bonus Rewards!)\n",
+                cache3v3Queue[MELEE], cache3v3Queue[RANGE], cache3v3Queue[HEALER]);
+        }
     }
 
     if (player->InBattlegroundQueueForBattlegroundQueueType((BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_3v3_SOLO))
@@ -54,7 +74,7 @@ bool NpcSolo3v3::OnGossipHello(Player* player, Creature* creature)
 
     if (!player->GetArenaTeamId(ArenaTeam::GetSlotByType(ARENA_TEAM_SOLO_3v3)))
     {
-        uint32 cost = sConfigMgr->GetOption<uint32>("Solo.3v3.Cost", 1);
+        uint32 cost = config.Cost;
 
         if (player->IsPvP())
             cost = 0;
@@ -75,13 +95,15 @@ bool NpcSolo3v3::OnGossipHello(Player* player, Creature* creature)
 
     AddGossipItemFor(player, GOSSIP_ICON_CHAT, "|TInterface/ICONS/INV_Misc_Coin_03:30|t How to Use NPC?", GOSSIP_SENDER_MAIN, 8);
 
-    AddGossipItemFor(player, GOSSIP_ICON_CHAT, infoQueue.str().c_str(), GOSSIP_SENDER_MAIN, 0);
+    AddGossipItemFor(player, GOSSIP_ICON_CHAT, infoQueue, GOSSIP_SENDER_MAIN, 0);
     SendGossipMenuFor(player, 60015, creature->GetGUID());
     return true;
 }
 
 bool NpcSolo3v3::OnGossipSelect(Player* player, Creature* creature, uint32 /*sender*/, uint32 action)
 {
+    SOLO_3V3_PROFILE_SCOPE("NpcSolo3v3::OnGossipSelect");
+
     if (!player || !creature)
         return true;
 
@@ -134,6 +156,8 @@ bool NpcSolo3v3::OnGossipSelect(Player* player, Creature* creature, uint32 /*sen
             {
                 uint8 arenaType = ARENA_TYPE_3v3_SOLO;
 
+                // the leave is handled, logged and sent to the remote matcher by
+                // OnBattlegroundDesertion(BG_DESERTION_TYPE_LEAVE_QUEUE) of the port opcode below
                 WorldPacket Data;
                 Data << arenaType << (uint8)0x0 << (uint32)BATTLEGROUND_AA << (uint16)0x0 << (uint8)0x0;
                 player->GetSession()->HandleBattleFieldPortOpcode(Data);
@@ -227,6 +251,8 @@ bool NpcSolo3v3::ArenaCheckFullEquipAndTalents(Player* player)
 
 bool NpcSolo3v3::JoinQueueArena(Player* player, Creature* creature, bool isRated)
 {
+    SOLO_3V3_PROFILE_SCOPE("NpcSolo3v3::JoinQueueArena");
+
     if (!player || !creature)
         return false;
 
@@ -242,6 +268,12 @@ bool NpcSolo3v3::JoinQueueArena(Player* player, Creature* creature, bool isRated
     if (player->InBattleground())
         return false;
 
+    if (uint32 lockout = sSoloLeaver->GetLockoutRemaining(player->GetGUID()))
+    {
+        ChatHandler(player->GetSession()).PSendSysMessage("You left too many solo arenas, you can queue again in %u minutes.", (lockout + MINUTE - 1) / MINUTE);
+        return false;
+    }
+
     //check existance
     Battleground* bg = sBattlegroundMgr->GetBattlegroundTemplate(BATTLEGROUND_AA);
 
@@ -289,24 +321,102 @@ bool NpcSolo3v3::JoinQueueArena(Player* player, Creature* creature, bool isRated
         // the arenateam id must match for everyone in the group
     }
 
+    // Duo queue: the leader of a group of two queues both players as one entry
+    Group* grp = nullptr;
+    Player* mate = nullptr;
+
+    if (sSolo->GetConfig().AllowDuoQueue && player->GetGroup() && player->GetGroup()->GetMembersCount() == 2 && player->GetGroup()->IsLeader(player->GetGUID()))
+    {
+        grp = player->GetGroup();
+        for (GroupReference* itr = grp->GetFirstMember(); itr != nullptr; itr = itr->next())
+            if (Player* member = itr->GetSource())
+                if (member != player)
+                    mate = member;
+
+        if (!mate)
+        {
+            ChatHandler(player->GetSession()).SendSysMessage("Your group mate must be online to queue as a duo.");
+            return false;
+        }
+
+        PvPDifficultyEntry const* mateBracketEntry = GetBattlegroundBracketByLevel(bg->GetMapId(), mate->getLevel());
+
+        if (mate->HasAura(26013) || sSoloLeaver->GetLockoutRemaining(mate->GetGUID()) || mate->InBattleground() || mate->GetBattlegroundQueueIndex(bgQueueTypeId) < PLAYER_MAX_BATTLEGROUND_QUEUES || !mate->HasFreeBattlegroundQueueId()
+            || sConfigMgr->GetOption<uint32>("Solo.3v3.MinLevel", 80) > mate->getLevel()
+            || !mateBracketEntry || mateBracketEntry->GetBracketId() != bracketEntry->GetBracketId()
+            || !ArenaCheckFullEquipAndTalents(mate))
+        {
+            ChatHandler(player->GetSession()).PSendSysMessage("%s can not join the solo queue right now.", mate->GetName().c_str());
+            return false;
+        }
+
+        if (sSolo->GetConfig().FilterTalents && sSolo->GetCachedTalentCatForSolo3v3(player) == sSolo->GetCachedTalentCatForSolo3v3(mate))
+        {
+            ChatHandler(player->GetSession()).SendSysMessage("A duo needs two different roles (melee, range, healer).");
+            return false;
+        }
+
+        if (isRated)
+        {
+            ArenaTeam* mateTeam = sArenaTeamMgr->GetArenaTeamById(mate->GetArenaTeamId(arenaslot));
+            if (!mateTeam)
+            {
+                mate->GetSession()->SendNotInArenaTeamPacket(arenatype);
+                ChatHandler(player->GetSession()).PSendSysMessage("%s has no solo arena team.", mate->GetName().c_str());
+                return false;
+            }
+
+            // each player is one third of the team, the entry carries the mean of both
+            arenaRating = (arenaRating + mateTeam->GetRating()) / 2;
+            matchmakerRating = arenaRating;
+        }
+    }
+
+    // The matcher holds the whole entry back when any of its players declines too often
+    for (Player* member : { player, mate })
+    {
+        if (!member || !sSoloInvites->IsDecliner(member->GetGUID()))
+            continue;
+
+        uint32 acceptRate = sSoloInvites->GetAcceptRate(member->GetGUID());
+        ChatHandler(member->GetSession()).PSendSysMessage("You accepted only %u%% of your recent solo arena invites, other players are matched before you.", acceptRate);
+
+        if (member == mate)
+            ChatHandler(player->GetSession()).PSendSysMessage("%s accepted only %u%% of their recent solo arena invites, other players are matched before your duo.", mate->GetName().c_str(), acceptRate);
+    }
+
     BattlegroundQueue& bgQueue = sBattlegroundMgr->GetBattlegroundQueue(bgQueueTypeId);
     BattlegroundTypeId bgTypeId = BATTLEGROUND_AA;
 
     bg->SetRated(isRated);
     bg->SetMinPlayersPerTeam(3);
 
-    GroupQueueInfo* ginfo = bgQueue.AddGroup(player, nullptr, bgTypeId, bracketEntry, arenatype, isRated != 0, false, arenaRating, matchmakerRating, ateamId, 0);
+    GroupQueueInfo* ginfo = bgQueue.AddGroup(player, grp, bgTypeId, bracketEntry, arenatype, isRated != 0, false, arenaRating, matchmakerRating, ateamId, 0);
     uint32 avgTime = bgQueue.GetAverageQueueWaitTime(ginfo);
-    uint32 queueSlot = player->AddBattlegroundQueueId(bgQueueTypeId);
 
-    // send status packet (in queue)
-    WorldPacket data;
-    sBattlegroundMgr->BuildBattlegroundStatusPacket(&data, bg, queueSlot, STATUS_WAIT_QUEUE, avgTime, 0, arenatype, TEAM_NEUTRAL, isRated);
-    player->GetSession()->SendPacket(&data);
+    Player* members[2] = { player, mate };
+    uint8 groupSize = mate ? 2 : 1;
+
+    for (uint8 i = 0; i < groupSize; i++)
+    {
+        uint32 queueSlot = members[i]->AddBattlegroundQueueId(bgQueueTypeId);
+
+        // send status packet (in queue)
+        WorldPacket data;
+        sBattlegroundMgr->BuildBattlegroundStatusPacket(&data, bg, queueSlot, STATUS_WAIT_QUEUE, avgTime, 0, arenatype, TEAM_NEUTRAL, isRated);
+        members[i]->GetSession()->SendPacket(&data);
+
+        Solo3v3TalentCat role = sSolo->GetCachedTalentCatForSolo3v3(members[i]);
+        sSolo->OnQueueJoin(members[i]->GetGUID(), bracketEntry->GetBracketId(), role, matchmakerRating);
+        sSoloRemote->SendJoin(members[i]->GetGUID(), bracketEntry->GetBracketId(), role, matchmakerRating, groupSize);
+        sSoloEvents->Log(SOLO_EVENT_JOIN, members[i]->GetGUID().GetCounter(), bracketEntry->GetBracketId(), 0, matchmakerRating, 0, 0, role);
+        sSoloForecast->OnJoin(bracketEntry->GetBracketId(), role);
+    }
 
     sBattlegroundMgr->ScheduleQueueUpdate(matchmakerRating, 5, bgQueueTypeId, bgTypeId, bracketEntry->GetBracketId());
 
-    sScriptMgr->OnPlayerJoinArena(player);
+    for (uint8 i = 0; i < groupSize; i++)
+        sScriptMgr->OnPlayerJoinArena(members[i]);
 
     return true;
 }
@@ -355,6 +465,9 @@ bool NpcSolo3v3::CreateArenateam(Player* player, Creature* creature)
     // Register arena team
     sArenaTeamMgr->AddArenaTeam(arenaTeam);
 
+    if (ArenaTeamMember* member = arenaTeam->GetMember(player->GetGUID()))
+        sSoloRating->OnRatingChange(player->GetGUID(), member->MatchMakerRating);
+
     ChatHandler(player->GetSession()).SendSysMessage("Arena team successful created!");
 
     return true;
@@ -362,6 +475,8 @@ bool NpcSolo3v3::CreateArenateam(Player* player, Creature* creature)
 
 void NpcSolo3v3::fetchQueueList()
 {
+    SOLO_3V3_PROFILE_SCOPE("NpcSolo3v3::fetchQueueList");
+
     if (GetMSTimeDiffToNow(lastFetchQueueList) < 1000)
         return;
 
@@ -387,7 +502,7 @@ void NpcSolo3v3::fetchQueueList()
                     if (!_player)
                         continue;
 
-                    Solo3v3TalentCat plrCat = sSolo->GetTalentCatForSolo3v3(_player); // get talent cat
+                    Solo3v3TalentCat plrCat = sSolo->GetCachedTalentCatForSolo3v3(_player); // get talent cat
                     cache3v3Queue[plrCat]++;
                 }
             }
@@ -400,6 +515,8 @@ void Solo3v3BG::OnQueueUpdate(BattlegroundQueue* queue, uint32 /*diff*/, Battleg
     if (arenaType != (ArenaType)ARENA_TYPE_3v3_SOLO)
         return;
 
+    SOLO_3V3_PROFILE_SCOPE("Solo3v3BG::OnQueueUpdate");
+
     Battleground* bg_template = sBattlegroundMgr->GetBattlegroundTemplate(bgTypeId);
 
     if (!bg_template)
@@ -409,48 +526,101 @@ void Solo3v3BG::OnQueueUpdate(BattlegroundQueue* queue, uint32 /*diff*/, Battleg
     if (!bracketEntry)
         return;
 
-    // Solo 3v3
-    if (sSolo->CheckSolo3v3Arena(queue, bracket_id))
-    {
-        Battleground* arena = sBattlegroundMgr->CreateNewBattleground(bgTypeId, bracketEntry, arenaType, isRated);
-        if (!arena)
-            return;
+    // Solo 3v3, proposals of the remote matcher while it is connected and not idle for the bracket
+    bool matched = false;
+    if (sSoloRemote->IsConnected())
+        matched = sSoloRemote->ApplyProposal(queue, bracket_id);
 
-        // Create temp arena team and store arenaTeamId
-        ArenaTeam* arenaTeams[BG_TEAMS_COUNT];
-        sSolo->CreateTempArenaTeamForQueue(queue, arenaTeams);
+    if (!matched && (!sSoloRemote->IsConnected() || sSoloRemote->IsIdle(bracket_id)))
+        matched = sSolo->CheckSolo3v3Arena(queue, bracket_id);
 
-        // invite those selection pools
-        for (uint32 i = 0; i < BG_TEAMS_COUNT; i++)
-            for (auto const& citr : queue->m_SelectionPools[TEAM_ALLIANCE + i].SelectedGroups)
-            {
-                citr->ArenaTeamId = arenaTeams[i]->GetId();
-                queue->InviteGroupToBG(citr, arena, citr->teamId);
-            }
+    GroupQueueInfo* badGroup = nullptr;
+    if (matched && sSolo->GetConfig().ValidateMatches && !sSolo->ValidateSolo3v3Selection(queue, bracket_id, badGroup))
+    {
+        SOLO_3V3_TRACE(bracket_id, SOLO_TRACE_INVALID);
+
+        // Drop the broken selection and leave the group it broke at out for a while, the rest is matched without it
+        if (badGroup)
+            sSolo->QuarantineSolo3v3Group(badGroup);
 
-        // Override ArenaTeamId to temp arena team (was first set in InviteGroupToBG)
-        arena->SetArenaTeamIdForTeam(TEAM_ALLIANCE, arenaTeams[TEAM_ALLIANCE]->GetId());
-        arena->SetArenaTeamIdForTeam(TEAM_HORDE, arenaTeams[TEAM_HORDE]->GetId());
+        queue->m_SelectionPools[TEAM_ALLIANCE].Init();
+        queue->m_SelectionPools[TEAM_HORDE].Init();
+        matched = false;
+    }
 
-        // Set matchmaker rating for calculating rating-modifier on EndBattleground (when a team has won/lost)
-        arena->SetArenaMatchmakerRating(TEAM_ALLIANCE, sSolo->GetAverageMMR(arenaTeams[TEAM_ALLIANCE]));
-        arena->SetArenaMatchmakerRating(TEAM_HORDE, sSolo->GetAverageMMR(arenaTeams[TEAM_HORDE]));
+    // Compare with the candidate matcher while the pools still hold the uninvited selection
+    sSoloShadow->Evaluate(queue, bracket_id, matched);
 
-        // start bg
-        arena->StartBattleground();
+    if (matched)
+    {
+        sSolo->CreateSolo3v3Arena(queue, bgTypeId, bracketEntry, arenaType, isRated);
     }
 }
 
+void Solo3v3BG::OnBattlegroundAddPlayer(Battleground* bg, Player* player)
+{
+    if (bg->GetArenaType() == ARENA_TYPE_3v3_SOLO)
+        sSolo->OnSolo3v3PlayerEntered(bg, player);
+}
+
 void Solo3v3BG::OnBattlegroundUpdate(Battleground* bg, uint32 /*diff*/)
 {
-    if (bg->GetStatus() != STATUS_IN_PROGRESS || !bg->isArena())
+    if (!bg->isArena())
+        return;
+
+    if (bg->GetArenaType() == ARENA_TYPE_3v3_SOLO)
+        sSolo->UpdateSolo3v3Stages(bg);
+
+    if (bg->GetStatus() == STATUS_WAIT_JOIN)
+    {
+        sSolo->BackfillSolo3v3Arena(bg);
+        return;
+    }
+
+    if (bg->GetStatus() != STATUS_IN_PROGRESS)
         return;
 
     sSolo->CheckStartSolo3v3Arena(bg);
 }
 
+void Solo3v3BG::OnBattlegroundEndReward(Battleground* bg, Player* player, TeamId winnerTeamId)
+{
+    // Runs for every player still in the arena, after the core updated the temp teams
+    if (bg->GetArenaType() == ARENA_TYPE_3v3_SOLO && bg->isRated())
+        sSolo->SaveSoloDB(bg, player->GetGUID(), winnerTeamId);
+}
+
+void Solo3v3BG::OnBattlegroundDestroy(Battleground* bg)
+{
+    if (bg->GetArenaType() != ARENA_TYPE_3v3_SOLO)
+        return;
+
+    if (Solo3v3ArenaInfo* info = sSolo->GetArenaInfo(bg->GetInstanceID()))
+    {
+        sSolo->ResolveSolo3v3Invites(*info);
+        sSoloLatency->Record(*info);
+        sSoloRemote->SendResult(*info, bg->GetWinner());
+        sSoloTournament->OnArenaEnded(*info, bg->GetWinner());
+    }
+
+    sSolo->CleanUp3v3SoloQ(bg);
+    sSolo->RemoveArenaInfo(bg->GetInstanceID());
+}
+
 void ConfigLoader3v3Arena::OnAfterConfigLoad(bool /*Reload*/)
 {
+    sSolo->LoadConfig();
+    sSoloShadow->LoadConfig();
+    sSoloRemote->LoadConfig();
+    sSoloTournament->LoadConfig();
+    sSoloLeaver->LoadConfig();
+    sSoloRating->LoadConfig();
+    sSoloEvents->LoadConfig();
+    sSoloMemory->LoadConfig();
+    sSoloForecast->LoadConfig();
+    sSoloInvites->LoadConfig();
+    sSoloProfiler->LoadConfig();
+
     ArenaTeam::ArenaSlotByType.emplace(ARENA_TEAM_SOLO_3v3, ARENA_SLOT_SOLO_3v3);
     ArenaTeam::ArenaReqPlayersForType.emplace(ARENA_TYPE_3v3_SOLO, 6);
 
@@ -459,6 +629,36 @@ void ConfigLoader3v3Arena::OnAfterConfigLoad(bool /*Reload*/)
     BattlegroundMgr::ArenaTypeToQueue.emplace(ARENA_TYPE_3v3_SOLO, (BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_3v3_SOLO);
 }
 
+void Solo3v3WorldScript::OnStartup()
+{
+    sSoloProfiler->BindThread();
+    sSolo->BindWorldThread();
+    LoadSolo3v3StartupData();
+    sSoloEvents->Start();
+}
+
+void Solo3v3WorldScript::OnUpdate(uint32 diff)
+{
+    sSoloRemote->Update(diff);
+    sSoloTournament->Update(diff);
+    sSoloLeaver->Update(diff);
+    sSolo->ApplyTalentCatInvalidations();
+    sSolo->UpdateRoleRewards(diff);
+    sSoloMemory->Update(diff);
+    sSoloForecast->Update(diff);
+    sSoloInvites->Update(diff);
+}
+
+void Solo3v3WorldScript::OnShutdown()
+{
+    sSoloRemote->Disconnect();
+    sSoloLeaver->SaveToDB();
+    sSoloInvites->SaveToDB();
+    JoinSolo3v3DumpWriters();
+    JoinSolo3v3ArchiveWriter();
+    sSoloEvents->Stop();
+}
+
 void Team3v3arena::OnGetSlotByType(const uint32 type, uint8& slot)
 {
     if (type == ARENA_TEAM_SOLO_3v3)
@@ -471,7 +671,7 @@ void Team3v3arena::OnGetArenaPoints(ArenaTeam* at, float& points)
 {
     if (at->GetType() == ARENA_TEAM_SOLO_3v3)
     {
-        points *= sConfigMgr->GetOption<float>("Solo.3v3.ArenaPointsMulti", 0.8f);
+        points *= sSolo->GetArenaPointsMultiplier(at->GetCaptain());
     }
 }
 
@@ -496,6 +696,74 @@ void PlayerScript3v3Arena::OnLogin(Player* pPlayer)
     ChatHandler(pPlayer->GetSession()).SendSysMessage("This server is running the |cff4CFF00Arena solo Q 3v3 |rmodule.");
 }
 
+void PlayerScript3v3Arena::OnLogout(Player* player)
+{
+    GroupQueueInfo ginfo;
+    if (sBattlegroundMgr->GetBattlegroundQueue(bgQueueTypeId).GetPlayerGroupInfoData(player->GetGUID(), &ginfo) && ginfo.ArenaType == ARENA_TYPE_3v3_SOLO)
+    {
+        sSoloRemote->SendLeave(player->GetGUID(), ginfo.BracketId);
+        sSoloEvents->Log(SOLO_EVENT_LEAVE, player->GetGUID().GetCounter(), ginfo.BracketId);
+    }
+
+    sSolo->OnQueueLeave(player->GetGUID());
+    sSolo->InvalidateTalentCat(player->GetGUID());
+}
+
+void PlayerScript3v3Arena::OnPlayerLearnTalents(Player* player, uint32 /*talentId*/, uint32 /*talentRank*/, uint32 /*spellid*/)
+{
+    sSolo->InvalidateTalentCat(player->GetGUID());
+}
+
+void PlayerScript3v3Arena::OnPlayerTalentsReset(Player* player, bool /*noCost*/)
+{
+    sSolo->InvalidateTalentCat(player->GetGUID());
+}
+
+void PlayerScript3v3Arena::OnAfterSpecSlotChanged(Player* player, uint8 /*newSlot*/)
+{
+    sSolo->InvalidateTalentCat(player->GetGUID());
+}
+
+void PlayerScript3v3Arena::OnBattlegroundDesertion(Player* player, BattlegroundDesertionType const desertionType)
+{
+    switch (desertionType)
+    {
+        case BG_DESERTION_TYPE_LEAVE_BG:
+        case BG_DESERTION_TYPE_OFFLINE:
+        {
+            Battleground* bg = player->GetBattleground();
+            if (bg && bg->GetArenaType() == ARENA_TYPE_3v3_SOLO && bg->GetStatus() != STATUS_WAIT_LEAVE)
+            {
+                sSoloLeaver->OnLeave(player);
+                sSoloEvents->Log(SOLO_EVENT_DESERT, player->GetGUID().GetCounter(), bg->GetBracketId(), bg->GetInstanceID(), 0, 0, player->GetBgTeamId());
+
+                // Leaving the running match loses it, the end reward no longer sees the player
+                if (bg->isRated() && bg->GetStatus() == STATUS_IN_PROGRESS)
+                    sSolo->SaveSoloDB(bg, player->GetGUID(), TEAM_NEUTRAL);
+            }
+            break;
+        }
+        default:
+        {
+            GroupQueueInfo ginfo;
+            if (!sBattlegroundMgr->GetBattlegroundQueue(bgQueueTypeId).GetPlayerGroupInfoData(player->GetGUID(), &ginfo) || ginfo.ArenaType != ARENA_TYPE_3v3_SOLO)
+                break;
+
+            if (desertionType == BG_DESERTION_TYPE_LEAVE_QUEUE)
+            {
+                sSolo->OnQueueLeave(player->GetGUID());
+                sSoloRemote->SendLeave(player->GetGUID(), ginfo.BracketId);
+                sSoloEvents->Log(SOLO_EVENT_LEAVE, player->GetGUID().GetCounter(), ginfo.BracketId);
+            }
+
+            // refused, ignored or logged out on an arena invite
+            if (ginfo.IsInvitedToBGInstanceGUID)
+                sSoloLeaver->OnLeave(player);
+            break;
+        }
+    }
+}
+
 void PlayerScript3v3Arena::GetCustomGetArenaTeamId(const Player* player, uint8 slot, uint32& id) const
 {
     if (slot == 2)
@@ -528,3 +796,191 @@ void PlayerScript3v3Arena::OnGetMaxPersonalArenaRatingRequirement(const Player*
         }
     }
 }
+
+ChatCommandTable CommandSolo3v3::GetCommands() const
+{
+    static ChatCommandTable tournamentCommandTable =
+    {
+        { "open",   HandleSoloqTournamentOpenCommand,   SEC_GAMEMASTER, Console::Yes },
+        { "join",   HandleSoloqTournamentJoinCommand,   SEC_PLAYER,     Console::No },
+        { "leave",  HandleSoloqTournamentLeaveCommand,  SEC_PLAYER,     Console::No },
+        { "start",  HandleSoloqTournamentStartCommand,  SEC_GAMEMASTER, Console::Yes },
+        { "stop",   HandleSoloqTournamentStopCommand,   SEC_GAMEMASTER, Console::Yes },
+        { "status", HandleSoloqTournamentStatusCommand, SEC_PLAYER,     Console::Yes },
+    };
+
+    static ChatCommandTable profileCommandTable =
+    {
+        { "dump",  HandleSoloqProfileDumpCommand,  SEC_ADMINISTRATOR, Console::Yes },
+        { "reset", HandleSoloqProfileResetCommand, SEC_ADMINISTRATOR, Console::Yes },
+    };
+
+    static ChatCommandTable soloqCommandTable =
+    {
+        { "trace", HandleSoloqTraceCommand, SEC_GAMEMASTER, Console::Yes },
+        { "dump",  HandleSoloqDumpCommand,  SEC_ADMINISTRATOR, Console::Yes },
+        { "reloadroles", HandleSoloqReloadRolesCommand, SEC_ADMINISTRATOR, Console::Yes },
+        { "latency", HandleSoloqLatencyCommand, SEC_GAMEMASTER, Console::Yes },
+        { "archive", HandleSoloqArchiveCommand, SEC_ADMINISTRATOR, Console::Yes },
+        { "memory", HandleSoloqMemoryCommand, SEC_GAMEMASTER, Console::Yes },
+        { "forecast", HandleSoloqForecastCommand, SEC_GAMEMASTER, Console::Yes },
+        { "tournament", tournamentCommandTable },
+        { "profile", profileCommandTable },
+    };
+
+    static ChatCommandTable commandTable =
+    {
+        { "soloq", soloqCommandTable },
+    };
+
+    return commandTable;
+}
+
+bool CommandSolo3v3::HandleSoloqTraceCommand(ChatHandler* handler, uint8 bracketId, Optional<uint32> count)
+{
+    if (bracketId >= MAX_BATTLEGROUND_BRACKETS)
+    {
+        handler->PSendSysMessage("Bracket must be lower than %u.", uint32(MAX_BATTLEGROUND_BRACKETS));
+        handler->SetSentErrorMessage(true);
+        return false;
+    }
+
+    sSoloTrace->Dump(handler, BattlegroundBracketId(bracketId), count.value_or(50));
+    return true;
+}
+
+bool CommandSolo3v3::HandleSoloqDumpCommand(ChatHandler* handler)
+{
+    std::string fileName;
+    if (!DumpSolo3v3State(fileName))
+    {
+        handler->SendSysMessage("Could not start writing the solo queue dump, see the server log.");
+        handler->SetSentErrorMessage(true);
+        return false;
+    }
+
+    handler->PSendSysMessage("Solo queue state is being written to %s.", fileName.c_str());
+    return true;
+}
+
+bool CommandSolo3v3::HandleSoloqReloadRolesCommand(ChatHandler* handler)
+{
+    uint32 count = sSoloRoles->Load();
+    handler->PSendSysMessage("Solo 3v3 talent roles reloaded, %u talent tabs from solo_3v3_talent_role.", count);
+    return true;
+}
+
+bool CommandSolo3v3::HandleSoloqLatencyCommand(ChatHandler* handler)
+{
+    sSoloLatency->Print(handler);
+    return true;
+}
+
+bool CommandSolo3v3::HandleSoloqArchiveCommand(ChatHandler* handler)
+{
+    std::string fileName;
+    if (!ArchiveSolo3v3Season(fileName))
+    {
+        handler->SendSysMessage("Could not start writing the solo season archive, see the server log.");
+        handler->SetSentErrorMessage(true);
+        return false;
+    }
+
+    handler->PSendSysMessage("Solo season archive is being written to %s.", fileName.c_str());
+    return true;
+}
+
+bool CommandSolo3v3::HandleSoloqMemoryCommand(ChatHandler* handler)
+{
+    sSoloMemory->Print(handler);
+    return true;
+}
+
+bool CommandSolo3v3::HandleSoloqForecastCommand(ChatHandler* handler)
+{
+    sSoloForecast->Print(handler);
+    return true;
+}
+
+bool CommandSolo3v3::HandleSoloqProfileDumpCommand(ChatHandler* handler)
+{
+    std::string fileName;
+    if (!sSoloProfiler->Dump(handler, fileName))
+    {
+        handler->SendSysMessage("Could not write the solo profile, see the server log.");
+        handler->SetSentErrorMessage(true);
+        return false;
+    }
+
+    handler->PSendSysMessage("Solo profile written to %s.", fileName.c_str());
+    return true;
+}
+
+bool CommandSolo3v3::HandleSoloqProfileResetCommand(ChatHandler* handler)
+{
+    sSoloProfiler->Reset();
+    handler->SendSysMessage("Solo profile counters reset.");
+    return true;
+}
+
+bool CommandSolo3v3::HandleSoloqTournamentOpenCommand(ChatHandler* handler)
+{
+    if (!sSoloTournament->Open())
+    {
+        handler->SendSysMessage("A solo tournament is already open or running.");
+        handler->SetSentErrorMessage(true);
+        return false;
+    }
+
+    return true;
+}
+
+bool CommandSolo3v3::HandleSoloqTournamentJoinCommand(ChatHandler* handler)
+{
+    if (!sSoloTournament->Register(handler->GetPlayer()))
+    {
+        handler->SendSysMessage("You can not join, either no tournament registration is open, you are already registered or your level is too low.");
+        handler->SetSentErrorMessage(true);
+        return false;
+    }
+
+    handler->SendSysMessage("You are registered for the solo tournament.");
+    return true;
+}
+
+bool CommandSolo3v3::HandleSoloqTournamentLeaveCommand(ChatHandler* handler)
+{
+    if (!sSoloTournament->Unregister(handler->GetPlayer()))
+    {
+        handler->SendSysMessage("You are not registered, or the tournament has already started.");
+        handler->SetSentErrorMessage(true);
+        return false;
+    }
+
+    handler->SendSysMessage("You left the solo tournament.");
+    return true;
+}
+
+bool CommandSolo3v3::HandleSoloqTournamentStartCommand(ChatHandler* handler, uint32 rounds)
+{
+    if (!sSoloTournament->Start(rounds))
+    {
+        handler->PSendSysMessage("Could not start, the registration must be open with at least %u players and rounds must be above 0.", uint32(BG_TEAMS_COUNT * 3));
+        handler->SetSentErrorMessage(true);
+        return false;
+    }
+
+    return true;
+}
+
+bool CommandSolo3v3::HandleSoloqTournamentStopCommand(ChatHandler* /*handler*/)
+{
+    sSoloTournament->Stop();
+    return true;
+}
+
+bool CommandSolo3v3::HandleSoloqTournamentStatusCommand(ChatHandler* handler)
+{
+    sSoloTournament->SendStatus(handler);
+    return true;
+}
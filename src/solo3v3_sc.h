@@ -24,7 +24,24 @@
 #include "ScriptedGossip.h"
 #include "Config.h"
 #include "Battleground.h"
+#include "Group.h"
 #include "solo3v3.h"
+#include "solo3v3_archive.h"
+#include "solo3v3_db.h"
+#include "solo3v3_dump.h"
+#include "solo3v3_events.h"
+#include "solo3v3_forecast.h"
+#include "solo3v3_invite.h"
+#include "solo3v3_latency.h"
+#include "solo3v3_leaver.h"
+#include "solo3v3_memory.h"
+#include "solo3v3_profile.h"
+#include "solo3v3_rating.h"
+#include "solo3v3_remote.h"
+#include "solo3v3_roles.h"
+#include "solo3v3_shadow.h"
+#include "solo3v3_tournament.h"
+#include "solo3v3_trace.h"
 
 class NpcSolo3v3 : public CreatureScript
 {
@@ -54,7 +71,10 @@ public:
     Solo3v3BG() : AllBattlegroundScript("Solo3v3_BG") {}
 
     void OnQueueUpdate(BattlegroundQueue* queue, uint32 /*diff*/, BattlegroundTypeId bgTypeId, BattlegroundBracketId bracket_id, uint8 arenaType, bool isRated, uint32 /*arenaRatedTeamId*/) override;
+    void OnBattlegroundAddPlayer(Battleground* bg, Player* player) override;
     void OnBattlegroundUpdate(Battleground* bg, uint32 /*diff*/) override;
+    void OnBattlegroundEndReward(Battleground* bg, Player* player, TeamId winnerTeamId) override;
+    void OnBattlegroundDestroy(Battleground* bg) override;
 };
 
 class ConfigLoader3v3Arena : public WorldScript
@@ -65,6 +85,16 @@ public:
     virtual void OnAfterConfigLoad(bool /*Reload*/) override;
 };
 
+class Solo3v3WorldScript : public WorldScript
+{
+public:
+    Solo3v3WorldScript() : WorldScript("solo_3v3_world_script") {}
+
+    void OnStartup() override;
+    void OnUpdate(uint32 diff) override;
+    void OnShutdown() override;
+};
+
 class Team3v3arena : public ArenaTeamScript
 {
 public:
@@ -82,11 +112,42 @@ public:
     PlayerScript3v3Arena() : PlayerScript("player_script_3v3_arena") {}
 
     void OnLogin(Player* pPlayer) override;
+    void OnLogout(Player* player) override;
+    void OnPlayerLearnTalents(Player* player, uint32 talentId, uint32 talentRank, uint32 spellid) override;
+    void OnPlayerTalentsReset(Player* player, bool noCost) override;
+    void OnAfterSpecSlotChanged(Player* player, uint8 newSlot) override;
+    void OnBattlegroundDesertion(Player* player, BattlegroundDesertionType const desertionType) override;
     void GetCustomGetArenaTeamId(const Player* player, uint8 slot, uint32& id) const override;
     void GetCustomArenaPersonalRating(const Player* player, uint8 slot, uint32& rating) const override;
     void OnGetMaxPersonalArenaRatingRequirement(const Player* player, uint32 minslot, uint32& maxArenaRating) const override;
 };
 
+using namespace Acore::ChatCommands;
+
+class CommandSolo3v3 : public CommandScript
+{
+public:
+    CommandSolo3v3() : CommandScript("solo_3v3_commandscript") {}
+
+    ChatCommandTable GetCommands() const override;
+
+    static bool HandleSoloqTraceCommand(ChatHandler* handler, uint8 bracketId, Optional<uint32> count);
+    static bool HandleSoloqDumpCommand(ChatHandler* handler);
+    static bool HandleSoloqReloadRolesCommand(ChatHandler* handler);
+    static bool HandleSoloqLatencyCommand(ChatHandler* handler);
+    static bool HandleSoloqArchiveCommand(ChatHandler* handler);
+    static bool HandleSoloqMemoryCommand(ChatHandler* handler);
+    static bool HandleSoloqForecastCommand(ChatHandler* handler);
+    static bool HandleSoloqProfileDumpCommand(ChatHandler* handler);
+    static bool HandleSoloqProfileResetCommand(ChatHandler* handler);
+    static bool HandleSoloqTournamentOpenCommand(ChatHandler* handler);
+    static bool HandleSoloqTournamentJoinCommand(ChatHandler* handler);
+    static bool HandleSoloqTournamentLeaveCommand(ChatHandler* handler);
+    static bool HandleSoloqTournamentStartCommand(ChatHandler* handler, uint32 rounds);
+    static bool HandleSoloqTournamentStopCommand(ChatHandler* handler);
+    static bool HandleSoloqTournamentStatusCommand(ChatHandler* handler);
+};
+
 void AddSC_Solo_3v3_Arena()
 {
     // ArenaSlotByType
@@ -128,5 +189,7 @@ void AddSC_Solo_3v3_Arena()
     new Solo3v3BG();
     new Team3v3arena();
     new ConfigLoader3v3Arena();
+    new Solo3v3WorldScript();
     new PlayerScript3v3Arena();
+    new CommandSolo3v3();
 }
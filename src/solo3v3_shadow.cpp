@@ -0,0 +1,375 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_shadow.h"
+#include "solo3v3_memory.h"
+#include "Config.h"
+#include "GameTime.h"
+#include "Log.h"
+
+constexpr uint32 SOLO_3V3_MATCH_SIZE = BG_TEAMS_COUNT * 3;
+
+void Solo3v3ShadowStats::Add(Solo3v3MatchMetrics const* metrics)
+{
+    Attempts++;
+    if (!metrics)
+        return;
+
+    Matches++;
+    if (metrics->RolesValid)
+        RoleValidMatches++;
+
+    SumMMRSpread += metrics->MMRSpread;
+    SumTeamMMRDiff += metrics->TeamMMRDiff;
+    SumWaitTime += metrics->AvgWaitTime;
+}
+
+Solo3v3ShadowMatcher* Solo3v3ShadowMatcher::instance()
+{
+    static Solo3v3ShadowMatcher instance;
+    return &instance;
+}
+
+void Solo3v3ShadowMatcher::LoadConfig()
+{
+    enabled = sConfigMgr->GetOption<bool>("Solo.3v3.Shadow.Enable", false);
+    maxEntries = sConfigMgr->GetOption<uint32>("Solo.3v3.Shadow.MaxEntries", 500);
+    budgetMicroseconds = sConfigMgr->GetOption<uint32>("Solo.3v3.Shadow.BudgetMicroseconds", 200);
+    reportInterval = sConfigMgr->GetOption<uint32>("Solo.3v3.Shadow.ReportInterval", 600);
+
+    snapshot.reserve(maxEntries);
+}
+
+void Solo3v3ShadowMatcher::Evaluate(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, bool liveMatched)
+{
+    if (!enabled)
+        return;
+
+    // GameTime moves once per world update, every bracket queue update of it shares one budget
+    uint32 tick = GameTime::GetGameTimeMS().count();
+    if (tick != tickTime)
+    {
+        tickTime = tick;
+        tickStart = std::chrono::steady_clock::now();
+        outOfBudget = false;
+    }
+
+    uint32 now = uint32(GameTime::GetGameTime().count());
+    if (reportInterval && now - lastReport >= reportInterval)
+    {
+        lastReport = now;
+        LogReport();
+    }
+
+    evaluations++;
+
+    Candidate const* picked[SOLO_3V3_MATCH_SIZE];
+    bool candidateMatched = false;
+
+    if (!OutOfBudget(0) && SnapshotQueue(queue, bracket_id) && !OutOfBudget(0))
+        candidateMatched = RunCandidate(picked, sSolo->GetConfig().FilterTalents);
+
+    if (outOfBudget)
+    {
+        // The candidate stopped half way, a partial result would skew the comparison. The live
+        // result of the evaluation is dropped as well, both matchers are counted on the same ones.
+        budgetSkips++;
+        return;
+    }
+
+    Solo3v3MatchMetrics liveMetrics;
+    if (liveMatched)
+        liveMetrics = MeasureLive(queue);
+
+    liveStats.Add(liveMatched ? &liveMetrics : nullptr);
+
+    if (!candidateMatched)
+        candidateStats.Add(nullptr);
+    else
+    {
+        uint32 mmr[SOLO_3V3_MATCH_SIZE];
+        uint32 joinTimes[SOLO_3V3_MATCH_SIZE];
+        Solo3v3TalentCat roles[SOLO_3V3_MATCH_SIZE];
+
+        for (uint32 i = 0; i < SOLO_3V3_MATCH_SIZE; i++)
+        {
+            mmr[i] = picked[i]->mmr;
+            joinTimes[i] = picked[i]->joinTime;
+            roles[i] = picked[i]->role;
+        }
+
+        Solo3v3MatchMetrics candidateMetrics = Measure(mmr, roles, joinTimes);
+        candidateStats.Add(&candidateMetrics);
+
+        if (liveMatched)
+        {
+            bothMatched++;
+
+            uint32 shared = 0;
+            for (uint32 i = 0; i < SOLO_3V3_MATCH_SIZE; i++)
+                for (int teamId = 0; teamId < BG_TEAMS_COUNT; teamId++)
+                    for (auto const& ginfo : queue->m_SelectionPools[teamId].SelectedGroups)
+                        if (ginfo == picked[i]->ginfo)
+                            shared++;
+
+            if (shared == SOLO_3V3_MATCH_SIZE)
+                samePlayers++;
+        }
+    }
+}
+
+bool Solo3v3ShadowMatcher::SnapshotQueue(BattlegroundQueue* queue, BattlegroundBracketId bracket_id)
+{
+    snapshot.clear();
+    uint32 step = 0;
+
+    for (int teamId = 0; teamId < BG_TEAMS_COUNT; teamId++)
+    {
+        for (auto const& ginfo : queue->m_QueuedGroups[bracket_id][teamId])
+        {
+            // the candidate only packs solo players
+            if (ginfo->IsInvitedToBGInstanceGUID || ginfo->Players.size() != 1)
+                continue;
+
+            if (snapshot.size() >= maxEntries)
+                return true; // the oldest entries are in front, the rest waits for a later tick
+
+            if (OutOfBudget(++step))
+                return false;
+
+            Player* plr = nullptr;
+            for (auto const& playerGuid : ginfo->Players)
+            {
+                plr = ObjectAccessor::FindPlayer(playerGuid);
+                break;
+            }
+
+            if (!plr)
+                continue;
+
+            snapshot.push_back({ ginfo, ginfo->ArenaMatchmakerRating, ginfo->JoinTime, sSolo->GetCachedTalentCatForSolo3v3(plr) });
+        }
+    }
+
+    return snapshot.size() >= SOLO_3V3_MATCH_SIZE;
+}
+
+// Candidate: the 6 queued players with the smallest MMR spread (2 of each role when filtering talents),
+// split so that the summed team MMRs are as close as possible.
+bool Solo3v3ShadowMatcher::RunCandidate(Candidate const* picked[], bool filterTalents)
+{
+    std::sort(snapshot.begin(), snapshot.end(), [](Candidate const& a, Candidate const& b) { return a.mmr < b.mmr; });
+
+    uint32 bestLeft = 0;
+    uint32 bestRight = 0;
+    uint32 bestSpread = std::numeric_limits<uint32>::max();
+    uint32 size = snapshot.size();
+
+    if (!filterTalents)
+    {
+        for (uint32 left = 0; left + SOLO_3V3_MATCH_SIZE <= size; left++)
+        {
+            if (OutOfBudget(left))
+                return false;
+
+            uint32 spread = snapshot[left + SOLO_3V3_MATCH_SIZE - 1].mmr - snapshot[left].mmr;
+            if (spread < bestSpread)
+            {
+                bestSpread = spread;
+                bestLeft = left;
+                bestRight = left + SOLO_3V3_MATCH_SIZE - 1;
+            }
+        }
+    }
+    else
+    {
+        // Two pointers: shrink the window from the left as long as it still holds 2 players of every role
+        uint32 roleCount[MAX_TALENT_CAT] = { 0, 0, 0 };
+        uint32 left = 0;
+
+        for (uint32 right = 0; right < size; right++)
+        {
+            if (OutOfBudget(right))
+                return false;
+
+            roleCount[snapshot[right].role]++;
+
+            while (roleCount[MELEE] >= 2 && roleCount[RANGE] >= 2 && roleCount[HEALER] >= 2)
+            {
+                uint32 spread = snapshot[right].mmr - snapshot[left].mmr;
+                if (spread < bestSpread)
+                {
+                    bestSpread = spread;
+                    bestLeft = left;
+                    bestRight = right;
+                }
+
+                roleCount[snapshot[left].role]--;
+                left++;
+            }
+        }
+    }
+
+    if (bestSpread == std::numeric_limits<uint32>::max())
+        return false;
+
+    // Take 2 players per role (or the 6 of the window) and give the stronger one of each pair to the weaker team
+    uint32 teamSum[BG_TEAMS_COUNT] = { 0, 0 };
+    uint32 teamSize[BG_TEAMS_COUNT] = { 0, 0 };
+    Candidate const* pair[MAX_TALENT_CAT][2] = { };
+    uint32 pairCount[MAX_TALENT_CAT] = { 0, 0, 0 };
+    Candidate const* ordered[SOLO_3V3_MATCH_SIZE];
+    uint32 orderedCount = 0;
+
+    for (uint32 i = bestRight + 1; i-- > bestLeft && orderedCount < SOLO_3V3_MATCH_SIZE;)
+    {
+        Candidate const* candidate = &snapshot[i];
+
+        if (filterTalents)
+        {
+            if (pairCount[candidate->role] >= 2)
+                continue;
+
+            pair[candidate->role][pairCount[candidate->role]++] = candidate;
+        }
+
+        ordered[orderedCount++] = candidate;
+    }
+
+    if (filterTalents)
+    {
+        orderedCount = 0;
+        for (int role = 0; role < MAX_TALENT_CAT; role++)
+        {
+            ordered[orderedCount++] = pair[role][0];
+            ordered[orderedCount++] = pair[role][1];
+        }
+    }
+
+    for (uint32 i = 0; i < SOLO_3V3_MATCH_SIZE; i += 2)
+    {
+        // ordered holds pairs with the higher MMR first
+        int weaker = teamSum[TEAM_ALLIANCE] <= teamSum[TEAM_HORDE] ? TEAM_ALLIANCE : TEAM_HORDE;
+        int stronger = 1 - weaker;
+
+        picked[weaker * 3 + teamSize[weaker]++] = ordered[i];
+        picked[stronger * 3 + teamSize[stronger]++] = ordered[i + 1];
+        teamSum[weaker] += ordered[i]->mmr;
+        teamSum[stronger] += ordered[i + 1]->mmr;
+    }
+
+    return true;
+}
+
+Solo3v3MatchMetrics Solo3v3ShadowMatcher::MeasureLive(BattlegroundQueue* queue)
+{
+    uint32 mmr[SOLO_3V3_MATCH_SIZE] = { };
+    uint32 joinTimes[SOLO_3V3_MATCH_SIZE] = { };
+    Solo3v3TalentCat roles[SOLO_3V3_MATCH_SIZE] = { };
+
+    for (int teamId = 0; teamId < BG_TEAMS_COUNT; teamId++)
+    {
+        uint32 slot = teamId * 3;
+
+        for (auto const& ginfo : queue->m_SelectionPools[teamId].SelectedGroups)
+        {
+            for (auto const& playerGuid : ginfo->Players)
+            {
+                if (slot >= uint32(teamId + 1) * 3)
+                    break;
+
+                Player* plr = ObjectAccessor::FindPlayer(playerGuid);
+
+                mmr[slot] = ginfo->ArenaMatchmakerRating;
+                joinTimes[slot] = ginfo->JoinTime;
+                roles[slot] = plr ? sSolo->GetCachedTalentCatForSolo3v3(plr) : MELEE;
+                slot++;
+            }
+        }
+    }
+
+    return Measure(mmr, roles, joinTimes);
+}
+
+Solo3v3MatchMetrics Solo3v3ShadowMatcher::Measure(uint32 const mmr[], Solo3v3TalentCat const roles[], uint32 const joinTimes[])
+{
+    Solo3v3MatchMetrics metrics;
+
+    uint32 minMMR = std::numeric_limits<uint32>::max();
+    uint32 maxMMR = 0;
+    uint32 teamSum[BG_TEAMS_COUNT] = { 0, 0 };
+    uint64 waitSum = 0;
+    uint32 now = GameTime::GetGameTimeMS().count();
+    metrics.RolesValid = true;
+
+    for (int teamId = 0; teamId < BG_TEAMS_COUNT; teamId++)
+    {
+        bool roleTaken[MAX_TALENT_CAT] = { false, false, false };
+
+        for (uint32 i = teamId * 3; i < uint32(teamId + 1) * 3; i++)
+        {
+            minMMR = std::min(minMMR, mmr[i]);
+            maxMMR = std::max(maxMMR, mmr[i]);
+            teamSum[teamId] += mmr[i];
+            waitSum += getMSTimeDiff(joinTimes[i], now);
+
+            if (roleTaken[roles[i]])
+                metrics.RolesValid = false;
+
+            roleTaken[roles[i]] = true;
+        }
+    }
+
+    metrics.MMRSpread = maxMMR - minMMR;
+    metrics.TeamMMRDiff = teamSum[TEAM_ALLIANCE] > teamSum[TEAM_HORDE] ? teamSum[TEAM_ALLIANCE] - teamSum[TEAM_HORDE] : teamSum[TEAM_HORDE] - teamSum[TEAM_ALLIANCE];
+    metrics.AvgWaitTime = waitSum / SOLO_3V3_MATCH_SIZE;
+    return metrics;
+}
+
+bool Solo3v3ShadowMatcher::BudgetExceeded() const
+{
+    return std::chrono::steady_clock::now() - tickStart > std::chrono::microseconds(budgetMicroseconds);
+}
+
+bool Solo3v3ShadowMatcher::OutOfBudget(uint32 step)
+{
+    if (!outOfBudget && step % SOLO_3V3_SHADOW_BUDGET_STRIDE == 0)
+        outOfBudget = BudgetExceeded();
+
+    return outOfBudget;
+}
+
+void Solo3v3ShadowMatcher::LogReport()
+{
+    auto avg = [](uint64 sum, uint32 count) -> uint64 { return count ? sum / count : 0; };
+
+    LOG_INFO("module", "Solo3v3 shadow: {} evaluations, {} over budget, {} ticks both matched, {} identical picks",
+        evaluations, budgetSkips, bothMatched, samePlayers);
+
+    LOG_INFO("module", "Solo3v3 shadow: live      attempts {} matches {} role-valid {} avg spread {} avg team diff {} avg wait {} ms",
+        liveStats.Attempts, liveStats.Matches, liveStats.RoleValidMatches, avg(liveStats.SumMMRSpread, liveStats.Matches),
+        avg(liveStats.SumTeamMMRDiff, liveStats.Matches), avg(liveStats.SumWaitTime, liveStats.Matches));
+
+    LOG_INFO("module", "Solo3v3 shadow: candidate attempts {} matches {} role-valid {} avg spread {} avg team diff {} avg wait {} ms",
+        candidateStats.Attempts, candidateStats.Matches, candidateStats.RoleValidMatches, avg(candidateStats.SumMMRSpread, candidateStats.Matches),
+        avg(candidateStats.SumTeamMMRDiff, candidateStats.Matches), avg(candidateStats.SumWaitTime, candidateStats.Matches));
+}
+
+void Solo3v3ShadowMatcher::ReportMemory(Solo3v3MemoryReport& report) const
+{
+    report.Add("shadow snapshot", Solo3v3VectorBytes(snapshot), snapshot.size());
+}
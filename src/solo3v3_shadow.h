@@ -0,0 +1,102 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_SHADOW_H_
+#define _SOLO_3V3_SHADOW_H_
+
+#include "solo3v3.h"
+#include <chrono>
+
+constexpr uint32 SOLO_3V3_SHADOW_BUDGET_STRIDE = 32;
+
+// Quality of one proposed match, measured the same way for the live and the candidate matcher
+struct Solo3v3MatchMetrics
+{
+    uint32 MMRSpread = 0;       // highest - lowest queued MMR of the 6 players
+    uint32 TeamMMRDiff = 0;     // difference of the summed team MMRs
+    uint32 AvgWaitTime = 0;     // ms the chosen players have been queued
+    bool RolesValid = false;    // each team has one melee, one caster and one healer
+};
+
+// Running totals for one matcher, over the evaluations both matchers finished
+struct Solo3v3ShadowStats
+{
+    uint32 Attempts = 0;
+    uint32 Matches = 0;
+    uint32 RoleValidMatches = 0;
+    uint64 SumMMRSpread = 0;
+    uint64 SumTeamMMRDiff = 0;
+    uint64 SumWaitTime = 0;
+
+    void Add(Solo3v3MatchMetrics const* metrics);   // nullptr: the matcher found nothing
+};
+
+// Runs a candidate matching algorithm next to CheckSolo3v3Arena on the same queue state.
+// Its proposals are never applied, only compared against the live selection.
+class Solo3v3ShadowMatcher
+{
+public:
+    static Solo3v3ShadowMatcher* instance();
+
+    void LoadConfig();
+    bool IsEnabled() const { return enabled; }
+    void ReportMemory(Solo3v3MemoryReport& report) const;
+
+    // Called right after CheckSolo3v3Arena, before anyone is invited. liveMatched tells if the selection pools hold a match.
+    void Evaluate(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, bool liveMatched);
+
+    void LogReport();
+
+private:
+    struct Candidate
+    {
+        GroupQueueInfo* ginfo;
+        uint32 mmr;
+        uint32 joinTime;
+        Solo3v3TalentCat role;
+    };
+
+    bool SnapshotQueue(BattlegroundQueue* queue, BattlegroundBracketId bracket_id);
+    bool RunCandidate(Candidate const* picked[], bool filterTalents);
+    Solo3v3MatchMetrics MeasureLive(BattlegroundQueue* queue);
+    Solo3v3MatchMetrics Measure(uint32 const mmr[], Solo3v3TalentCat const roles[], uint32 const joinTimes[]);
+    bool BudgetExceeded() const;
+    // Checked inside the loops, the clock is only read every SOLO_3V3_SHADOW_BUDGET_STRIDE steps
+    bool OutOfBudget(uint32 step);
+
+    bool enabled = false;
+    uint32 maxEntries = 500;
+    uint32 budgetMicroseconds = 200;
+    uint32 reportInterval = 600;
+
+    std::vector<Candidate> snapshot; // reused between ticks, never shrinks
+    std::chrono::steady_clock::time_point tickStart;    // first evaluation of the world update
+    uint32 tickTime = 0;                                // GameTime ms of that world update
+    bool outOfBudget = false;                           // budget of the world update used up
+
+    uint32 evaluations = 0;
+    uint32 budgetSkips = 0;
+    uint32 bothMatched = 0;
+    uint32 samePlayers = 0;
+    Solo3v3ShadowStats liveStats;
+    Solo3v3ShadowStats candidateStats;
+    uint32 lastReport = 0;
+};
+
+#define sSoloShadow Solo3v3ShadowMatcher::instance()
+
+#endif // _SOLO_3V3_SHADOW_H_
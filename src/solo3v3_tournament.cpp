@@ -0,0 +1,417 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_tournament.h"
+#include "solo3v3_memory.h"
+#include "BattlegroundMgr.h"
+#include "CharacterCache.h"
+#include "Chat.h"
+#include "Config.h"
+#include "Log.h"
+#include "ObjectAccessor.h"
+#include "StringFormat.h"
+#include "World.h"
+
+Solo3v3Tournament* Solo3v3Tournament::instance()
+{
+    static Solo3v3Tournament instance;
+    return &instance;
+}
+
+void Solo3v3Tournament::LoadConfig()
+{
+    rated = sConfigMgr->GetOption<bool>("Solo.3v3.Tournament.Rated", false);
+    arenasPerTick = std::max<uint32>(1, sConfigMgr->GetOption<uint32>("Solo.3v3.Tournament.ArenasPerTick", 5));
+}
+
+void Solo3v3Tournament::Update(uint32 /*diff*/)
+{
+    if (state != SOLO_TOURNAMENT_SCHEDULING)
+        return;
+
+    // Creating an arena loads a map instance, spread a big round over several world ticks
+    for (uint32 created = 0; created < arenasPerTick && nextPairing < pendingPairings.size(); created++)
+        CreatePairingArena(pendingPairings[nextPairing++]);
+
+    if (nextPairing < pendingPairings.size())
+        return;
+
+    pendingPairings.clear();
+    nextPairing = 0;
+    state = SOLO_TOURNAMENT_PLAYING;
+
+    // every pairing of the round failed
+    if (runningArenas.empty())
+        FinishRound();
+}
+
+bool Solo3v3Tournament::Open()
+{
+    if (state != SOLO_TOURNAMENT_IDLE)
+        return false;
+
+    players.clear();
+    met.clear();
+    runningArenas.clear();
+    currentRound = 0;
+    roundCount = 0;
+    state = SOLO_TOURNAMENT_REGISTRATION;
+
+    Announce("Solo 3v3 tournament registration is open, use .soloq tournament join to take part.");
+    return true;
+}
+
+bool Solo3v3Tournament::Register(Player* player)
+{
+    if (state != SOLO_TOURNAMENT_REGISTRATION || FindPlayer(player->GetGUID()))
+        return false;
+
+    if (sConfigMgr->GetOption<uint32>("Solo.3v3.MinLevel", 80) > player->getLevel())
+        return false;
+
+    Solo3v3TournamentPlayer entry;
+    entry.Guid = player->GetGUID();
+
+    if (ArenaTeam* at = sArenaTeamMgr->GetArenaTeamById(player->GetArenaTeamId(ArenaTeam::GetSlotByType(ARENA_TEAM_SOLO_3v3))))
+    {
+        if (ArenaTeamMember const* member = at->GetMember(player->GetGUID()))
+            entry.MMR = member->MatchMakerRating;
+        else
+            entry.MMR = at->GetRating();
+    }
+
+    players.push_back(entry);
+    return true;
+}
+
+bool Solo3v3Tournament::Unregister(Player* player)
+{
+    if (state != SOLO_TOURNAMENT_REGISTRATION)
+        return false;
+
+    auto itr = std::find_if(players.begin(), players.end(), [&](Solo3v3TournamentPlayer const& entry) { return entry.Guid == player->GetGUID(); });
+    if (itr == players.end())
+        return false;
+
+    players.erase(itr);
+    return true;
+}
+
+bool Solo3v3Tournament::Start(uint32 rounds)
+{
+    if (state != SOLO_TOURNAMENT_REGISTRATION || !rounds || players.size() < BG_TEAMS_COUNT * 3)
+        return false;
+
+    roundCount = rounds;
+    currentRound = 0;
+    met.assign(players.size() * players.size(), false);
+
+    Announce(Acore::StringFormat("Solo 3v3 tournament starts with {} players over {} rounds.", players.size(), roundCount));
+    PairRound();
+    return true;
+}
+
+void Solo3v3Tournament::Stop()
+{
+    if (state == SOLO_TOURNAMENT_IDLE)
+        return;
+
+    // Running arenas are played to the end, their results are just not counted any more
+    players.clear();
+    pendingPairings.clear();
+    nextPairing = 0;
+    runningArenas.clear();
+    state = SOLO_TOURNAMENT_IDLE;
+
+    Announce("Solo 3v3 tournament was stopped.");
+}
+
+void Solo3v3Tournament::OnArenaEnded(Solo3v3ArenaInfo const& info, TeamId winner)
+{
+    if (!runningArenas.erase(info.InstanceId))
+        return;
+
+    if (winner == TEAM_ALLIANCE || winner == TEAM_HORDE)
+        for (uint8 slot = 0; slot < info.PlayerCount[winner]; slot++)
+            if (Solo3v3TournamentPlayer* entry = FindPlayer(info.Players[winner][slot]))
+                entry->Score++;
+
+    if (state == SOLO_TOURNAMENT_PLAYING && runningArenas.empty())
+        FinishRound();
+}
+
+void Solo3v3Tournament::SendStatus(ChatHandler* handler) const
+{
+    static char const* stateNames[] = { "idle", "registration", "creating arenas", "playing" };
+
+    handler->PSendSysMessage("Solo 3v3 tournament: %s, %u players, round %u of %u, %u arenas running.",
+        stateNames[state], uint32(players.size()), currentRound, roundCount, uint32(runningArenas.size()));
+
+    std::vector<Solo3v3TournamentPlayer> standings(players);
+    std::sort(standings.begin(), standings.end(), [](Solo3v3TournamentPlayer const& a, Solo3v3TournamentPlayer const& b)
+    {
+        return a.Score != b.Score ? a.Score > b.Score : a.MMR > b.MMR;
+    });
+
+    for (size_t i = 0; i < standings.size() && i < 10; i++)
+    {
+        std::string name;
+        if (!sCharacterCache->GetCharacterNameByGuid(standings[i].Guid, name))
+            name = "<unknown>";
+
+        handler->PSendSysMessage("%u. %s - %u points, %u played, %u mmr", uint32(i + 1), name.c_str(), standings[i].Score, standings[i].Played, standings[i].MMR);
+    }
+}
+
+Solo3v3TournamentPlayer* Solo3v3Tournament::FindPlayer(ObjectGuid guid)
+{
+    for (auto& entry : players)
+        if (entry.Guid == guid)
+            return &entry;
+
+    return nullptr;
+}
+
+void Solo3v3Tournament::PairRound()
+{
+    currentRound++;
+
+    // Swiss pairing: players with the same score meet, MMR breaks ties so the groups stay close
+    std::vector<uint32> order(players.size());
+    for (uint32 i = 0; i < order.size(); i++)
+        order[i] = i;
+
+    std::sort(order.begin(), order.end(), [this](uint32 a, uint32 b)
+    {
+        if (players[a].Score != players[b].Score)
+            return players[a].Score > players[b].Score;
+
+        return players[a].MMR > players[b].MMR;
+    });
+
+    uint32 const matchSize = BG_TEAMS_COUNT * 3;
+    size_t groupCount = order.size() / matchSize;
+
+    pendingPairings.clear();
+    pendingPairings.reserve(groupCount);
+    nextPairing = 0;
+
+    std::vector<bool> assigned(order.size(), false);
+    uint32 rematches = 0;
+
+    for (size_t group = 0; group < groupCount; group++)
+    {
+        // places in order, the first free one opens the group
+        uint32 seeds[matchSize];
+        uint32 count = 0;
+        size_t first = 0;
+
+        while (assigned[first])
+            first++;
+
+        seeds[count++] = uint32(first);
+        assigned[first] = true;
+
+        while (count < matchSize)
+        {
+            size_t pick = order.size();
+            size_t fallback = order.size();
+
+            for (size_t i = first + 1; i < order.size() && i <= first + SOLO_TOURNAMENT_REMATCH_LOOKAHEAD; i++)
+            {
+                if (assigned[i])
+                    continue;
+
+                if (fallback == order.size())
+                    fallback = i;
+
+                bool fresh = true;
+                for (uint32 member = 0; member < count && fresh; member++)
+                    fresh = !HaveMet(order[i], order[seeds[member]]);
+
+                if (fresh)
+                {
+                    pick = i;
+                    break;
+                }
+            }
+
+            // everybody close already met someone of the group, take the next in the standings
+            if (pick == order.size())
+            {
+                pick = fallback != order.size() ? fallback : first + 1;
+                while (assigned[pick])
+                    pick++;
+
+                rematches++;
+            }
+
+            seeds[count++] = uint32(pick);
+            assigned[pick] = true;
+        }
+
+        std::sort(seeds, seeds + matchSize);
+
+        // 1-4-5 against 2-3-6, both sides get a similar rank sum
+        Pairing pairing;
+        pairing.Players[0] = order[seeds[0]];
+        pairing.Players[1] = order[seeds[3]];
+        pairing.Players[2] = order[seeds[4]];
+        pairing.Players[3] = order[seeds[1]];
+        pairing.Players[4] = order[seeds[2]];
+        pairing.Players[5] = order[seeds[5]];
+        pendingPairings.push_back(pairing);
+    }
+
+    // the players left over sit this round out, the lowest ranked unless they were passed over for rematches
+    for (size_t i = 0; i < order.size(); i++)
+        if (!assigned[i])
+            players[order[i]].Score++;
+
+    if (rematches)
+        LOG_INFO("module", "Solo3v3Tournament: round {} has {} players placed with someone they already played with.", currentRound, rematches);
+
+    Announce(Acore::StringFormat("Solo 3v3 tournament round {} of {}: {} arenas, {} byes.",
+        currentRound, roundCount, pendingPairings.size(), order.size() - groupCount * matchSize));
+
+    state = SOLO_TOURNAMENT_SCHEDULING;
+}
+
+bool Solo3v3Tournament::CreatePairingArena(Pairing const& pairing)
+{
+    uint32 const matchSize = BG_TEAMS_COUNT * 3;
+
+    Battleground* bgTemplate = sBattlegroundMgr->GetBattlegroundTemplate(BATTLEGROUND_AA);
+    if (!bgTemplate)
+        return false;
+
+    // Everybody has to be online, out of battlegrounds and in the same bracket
+    Player* matchPlayers[matchSize];
+    PvPDifficultyEntry const* bracketEntry = nullptr;
+    bool complete = true;
+
+    for (uint32 i = 0; i < matchSize; i++)
+    {
+        Player* player = ObjectAccessor::FindPlayer(players[pairing.Players[i]].Guid);
+        matchPlayers[i] = player;
+
+        if (!player || player->InBattleground() || player->InBattlegroundQueue() || !player->HasFreeBattlegroundQueueId())
+        {
+            complete = false;
+            continue;
+        }
+
+        PvPDifficultyEntry const* entry = GetBattlegroundBracketByLevel(bgTemplate->GetMapId(), player->getLevel());
+        if (!entry || (bracketEntry && entry->GetBracketId() != bracketEntry->GetBracketId()))
+            complete = false;
+        else
+            bracketEntry = entry;
+    }
+
+    // Missing players lose the round, the ones that showed up get a bye
+    if (!complete)
+    {
+        for (uint32 i = 0; i < matchSize; i++)
+            if (matchPlayers[i] && !matchPlayers[i]->InBattleground() && !matchPlayers[i]->InBattlegroundQueue())
+            {
+                players[pairing.Players[i]].Score++;
+                ChatHandler(matchPlayers[i]->GetSession()).SendSysMessage("Not all players of your tournament arena are available, you get a bye for this round.");
+            }
+
+        return false;
+    }
+
+    BattlegroundQueue& queue = sBattlegroundMgr->GetBattlegroundQueue(bgQueueTypeId);
+    BattlegroundBracketId bracketId = bracketEntry->GetBracketId();
+
+    queue.m_SelectionPools[TEAM_ALLIANCE].Init();
+    queue.m_SelectionPools[TEAM_HORDE].Init();
+
+    // Same queue entries as JoinQueueArena, then moved straight into the selection pools of their side
+    for (uint32 i = 0; i < matchSize; i++)
+    {
+        Player* player = matchPlayers[i];
+        uint32 mmr = players[pairing.Players[i]].MMR;
+        TeamId teamId = TeamId(i / 3);
+
+        GroupQueueInfo* ginfo = queue.AddGroup(player, nullptr, BATTLEGROUND_AA, bracketEntry, ARENA_TYPE_3v3_SOLO, rated, false, mmr, mmr, 0, 0);
+        player->AddBattlegroundQueueId(bgQueueTypeId);
+
+        sSolo->MoveQueuedGroupToTeam(&queue, bracketId, ginfo, teamId);
+        queue.m_SelectionPools[teamId].AddGroup(ginfo, 3);
+    }
+
+    Battleground* arena = sSolo->CreateSolo3v3Arena(&queue, BATTLEGROUND_AA, bracketEntry, ARENA_TYPE_3v3_SOLO, rated);
+    if (!arena)
+    {
+        LOG_ERROR("module", "Solo3v3Tournament: could not create arena for round {}, players get a bye.", currentRound);
+
+        for (uint32 i = 0; i < matchSize; i++)
+        {
+            queue.RemovePlayer(matchPlayers[i]->GetGUID(), false);
+            matchPlayers[i]->RemoveBattlegroundQueueId(bgQueueTypeId);
+            players[pairing.Players[i]].Score++;
+        }
+
+        return false;
+    }
+
+    for (uint32 i = 0; i < matchSize; i++)
+    {
+        players[pairing.Players[i]].Played++;
+
+        for (uint32 j = 0; j < matchSize; j++)
+            met[pairing.Players[i] * players.size() + pairing.Players[j]] = true;
+    }
+
+    runningArenas.insert(arena->GetInstanceID());
+    return true;
+}
+
+void Solo3v3Tournament::FinishRound()
+{
+    if (currentRound < roundCount)
+    {
+        PairRound();
+        return;
+    }
+
+    Solo3v3TournamentPlayer const* winner = nullptr;
+    for (auto const& entry : players)
+        if (!winner || entry.Score > winner->Score || (entry.Score == winner->Score && entry.MMR > winner->MMR))
+            winner = &entry;
+
+    std::string name;
+    if (winner && sCharacterCache->GetCharacterNameByGuid(winner->Guid, name))
+        Announce(Acore::StringFormat("Solo 3v3 tournament is over, {} wins with {} points.", name, winner->Score));
+    else
+        Announce("Solo 3v3 tournament is over.");
+
+    // standings stay readable through .soloq tournament status until the next one opens
+    state = SOLO_TOURNAMENT_IDLE;
+}
+
+void Solo3v3Tournament::Announce(std::string const& text) const
+{
+    LOG_INFO("module", "{}", text);
+    sWorld->SendServerMessage(SERVER_MSG_STRING, text);
+}
+
+void Solo3v3Tournament::ReportMemory(Solo3v3MemoryReport& report) const
+{
+    report.Add("tournament", Solo3v3VectorBytes(players) + Solo3v3VectorBytes(pendingPairings) + Solo3v3HashBytes(runningArenas), players.size());
+}
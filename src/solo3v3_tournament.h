@@ -0,0 +1,104 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_TOURNAMENT_H_
+#define _SOLO_3V3_TOURNAMENT_H_
+
+#include "solo3v3.h"
+#include <unordered_set>
+
+class ChatHandler;
+
+constexpr uint32 SOLO_TOURNAMENT_REMATCH_LOOKAHEAD = 12;  // standings places searched for a fresh opponent
+
+enum Solo3v3TournamentState
+{
+    SOLO_TOURNAMENT_IDLE = 0,
+    SOLO_TOURNAMENT_REGISTRATION,
+    SOLO_TOURNAMENT_SCHEDULING,     // arenas of the current round are being created, a few per tick
+    SOLO_TOURNAMENT_PLAYING,        // waiting for the arenas of the current round to end
+};
+
+struct Solo3v3TournamentPlayer
+{
+    ObjectGuid Guid;
+    uint32 MMR = 0;
+    uint32 Score = 0;               // 1 point per won match or bye
+    uint32 Played = 0;
+};
+
+/*
+ * Swiss style solo tournament.
+ *
+ * Each round sorts the registered players by score, then MMR, and cuts the list into groups of six:
+ * neighbours in the standings meet, the group is split 1-4-5 / 2-3-6 to even out the teams.
+ * A player who already shared an arena with someone of the group is passed over for the next one
+ * within SOLO_TOURNAMENT_REMATCH_LOOKAHEAD places, rematches only happen when nobody close is left.
+ * Players left over get a bye. The arenas of a round go through the same temp team path as the
+ * queue (Solo3v3::CreateSolo3v3Arena) and are created Solo.3v3.Tournament.ArenasPerTick at a time.
+ */
+class Solo3v3Tournament
+{
+public:
+    static Solo3v3Tournament* instance();
+
+    void LoadConfig();
+    void Update(uint32 diff);
+    void ReportMemory(Solo3v3MemoryReport& report) const;
+
+    bool Open();
+    bool Register(Player* player);
+    bool Unregister(Player* player);
+    bool Start(uint32 rounds);
+    void Stop();
+
+    // A solo arena ended, credits the winners if it belongs to the running round
+    void OnArenaEnded(Solo3v3ArenaInfo const& info, TeamId winner);
+    bool IsTournamentArena(uint32 instanceId) const { return runningArenas.count(instanceId) != 0; }
+
+    void SendStatus(ChatHandler* handler) const;
+
+private:
+    struct Pairing
+    {
+        uint32 Players[BG_TEAMS_COUNT * 3];  // indexes into players, [0..2] alliance side
+    };
+
+    Solo3v3TournamentPlayer* FindPlayer(ObjectGuid guid);
+    bool HaveMet(uint32 a, uint32 b) const { return met[a * players.size() + b]; }
+    void PairRound();
+    bool CreatePairingArena(Pairing const& pairing);
+    void FinishRound();
+    void Announce(std::string const& text) const;
+
+    bool rated = false;
+    uint32 arenasPerTick = 5;
+
+    Solo3v3TournamentState state = SOLO_TOURNAMENT_IDLE;
+    uint32 roundCount = 0;
+    uint32 currentRound = 0;
+
+    std::vector<Solo3v3TournamentPlayer> players;
+    std::vector<bool> met;                      // [a * players.size() + b]: shared an arena, set on Start
+    std::vector<Pairing> pendingPairings;       // not created yet
+    size_t nextPairing = 0;
+    std::unordered_set<uint32> runningArenas;   // instance ids of the current round
+};
+
+#define sSoloTournament Solo3v3Tournament::instance()
+
+#endif // _SOLO_3V3_TOURNAMENT_H_
@@ -0,0 +1,117 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_trace.h"
+#include "solo3v3_memory.h"
+#include "Chat.h"
+#include "Timer.h"
+
+Solo3v3Trace* Solo3v3Trace::instance()
+{
+    static Solo3v3Trace instance;
+    return &instance;
+}
+
+#ifdef SOLO_3V3_TRACE_ENABLED
+
+static char const* const TraceEventNames[SOLO_TRACE_MAX] =
+{
+    "pass start",
+    "skip invited",
+    "skip offline",
+    "skip decliner",
+    "skip quarantined",
+    "candidate",
+    "reject role taken",
+    "reject pool full",
+    "reject mmr window",
+    "selected",
+    "moved faction",
+    "match",
+    "no match",
+    "invalid selection"
+};
+
+void Solo3v3Trace::BeginPass(BattlegroundBracketId bracket_id)
+{
+    rings[bracket_id].Pass++;
+}
+
+void Solo3v3Trace::Record(BattlegroundBracketId bracket_id, Solo3v3TraceEvent event, ObjectGuid::LowType guid, uint8 team, uint8 role, uint32 value)
+{
+    Ring& ring = rings[bracket_id];
+
+    Solo3v3TraceRecord& record = ring.Records[ring.Head];
+    record.Time = getMSTime();
+    record.Pass = ring.Pass;
+    record.Guid = guid;
+    record.Value = value;
+    record.Event = event;
+    record.Team = team;
+    record.Role = role;
+
+    ring.Head = (ring.Head + 1) % SOLO_3V3_TRACE_SIZE;
+    if (ring.Size < SOLO_3V3_TRACE_SIZE)
+        ring.Size++;
+}
+
+void Solo3v3Trace::Dump(ChatHandler* handler, BattlegroundBracketId bracket_id, uint32 count) const
+{
+    Ring const& ring = rings[bracket_id];
+
+    count = std::min(count, ring.Size);
+    if (!count)
+    {
+        handler->PSendSysMessage("No matcher trace recorded for bracket %u.", uint32(bracket_id));
+        return;
+    }
+
+    uint32 now = getMSTime();
+    uint32 index = (ring.Head + SOLO_3V3_TRACE_SIZE - count) % SOLO_3V3_TRACE_SIZE;
+
+    for (uint32 i = 0; i < count; i++)
+    {
+        Solo3v3TraceRecord const& record = ring.Records[index];
+
+        handler->PSendSysMessage("-%ums pass %u: %s guid %u team %u role %u value %u", getMSTimeDiff(record.Time, now), record.Pass,
+            record.Event < SOLO_TRACE_MAX ? TraceEventNames[record.Event] : "?", uint32(record.Guid), uint32(record.Team), uint32(record.Role), record.Value);
+
+        index = (index + 1) % SOLO_3V3_TRACE_SIZE;
+    }
+}
+
+#else
+
+void Solo3v3Trace::BeginPass(BattlegroundBracketId /*bracket_id*/) { }
+
+void Solo3v3Trace::Record(BattlegroundBracketId /*bracket_id*/, Solo3v3TraceEvent /*event*/, ObjectGuid::LowType /*guid*/, uint8 /*team*/, uint8 /*role*/, uint32 /*value*/) { }
+
+void Solo3v3Trace::Dump(ChatHandler* handler, BattlegroundBracketId /*bracket_id*/, uint32 /*count*/) const
+{
+    handler->SendSysMessage("The solo matcher trace is not built in. Rebuild with ACORE_DEBUG or SOLO_3V3_MATCH_TRACE defined.");
+}
+
+#endif
+
+void Solo3v3Trace::ReportMemory(Solo3v3MemoryReport& report) const
+{
+#ifdef SOLO_3V3_TRACE_ENABLED
+    report.Add("matcher trace", sizeof(rings), MAX_BATTLEGROUND_BRACKETS * SOLO_3V3_TRACE_SIZE);
+#else
+    report.Add("matcher trace", 0, 0);
+#endif
+}
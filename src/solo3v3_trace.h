@@ -0,0 +1,102 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_TRACE_H_
+#define _SOLO_3V3_TRACE_H_
+
+#include "Common.h"
+#include "DBCEnums.h"
+#include "ObjectGuid.h"
+
+class ChatHandler;
+class Solo3v3MemoryReport;
+
+// Matcher decision trace. Built in debug builds (ACORE_DEBUG) or when SOLO_3V3_MATCH_TRACE is defined,
+// otherwise every SOLO_3V3_TRACE() compiles to nothing.
+#if defined(ACORE_DEBUG) || defined(SOLO_3V3_MATCH_TRACE)
+#define SOLO_3V3_TRACE_ENABLED
+#endif
+
+enum Solo3v3TraceEvent : uint8
+{
+    SOLO_TRACE_PASS_START = 0,      // value = queued groups looked at (window size)
+    SOLO_TRACE_SKIP_INVITED,        // group already invited to an instance
+    SOLO_TRACE_SKIP_OFFLINE,        // player not found
+    SOLO_TRACE_SKIP_DECLINER,       // value = ms queued, held back for letting invites expire
+    SOLO_TRACE_SKIP_QUARANTINED,    // player of a group a broken selection was dropped for
+    SOLO_TRACE_CANDIDATE,           // player considered, role = slot asked for
+    SOLO_TRACE_REJECT_ROLE_TAKEN,   // slot of that role taken in both teams
+    SOLO_TRACE_REJECT_POOL_FULL,    // selection pool refused the group
+    SOLO_TRACE_REJECT_MMR_WINDOW,   // value = MMR difference to the anchor group, above the match window
+    SOLO_TRACE_SELECTED,            // team = side the group was put on, value = players in the group
+    SOLO_TRACE_MOVED_FACTION,       // picked group moved to the queue list of the side it plays on
+    SOLO_TRACE_MATCH,               // value = alliance players, team = horde players of the chosen split
+    SOLO_TRACE_NO_MATCH,            // value = players selected when giving up
+    SOLO_TRACE_INVALID,             // selection dropped by ValidateSolo3v3Selection
+    SOLO_TRACE_MAX
+};
+
+struct Solo3v3TraceRecord
+{
+    uint32 Time;                // getMSTime()
+    uint32 Pass;                // matcher run the record belongs to
+    ObjectGuid::LowType Guid;
+    uint32 Value;
+    uint8 Event;
+    uint8 Team;
+    uint8 Role;
+};
+
+constexpr uint32 SOLO_3V3_TRACE_SIZE = 512; // records kept per bracket
+
+class Solo3v3Trace
+{
+public:
+    static Solo3v3Trace* instance();
+
+    void BeginPass(BattlegroundBracketId bracket_id);
+    void Record(BattlegroundBracketId bracket_id, Solo3v3TraceEvent event, ObjectGuid::LowType guid = 0, uint8 team = 0, uint8 role = 0, uint32 value = 0);
+    void ReportMemory(Solo3v3MemoryReport& report) const;
+
+    // Prints the last count records of a bracket, oldest first
+    void Dump(ChatHandler* handler, BattlegroundBracketId bracket_id, uint32 count) const;
+
+private:
+#ifdef SOLO_3V3_TRACE_ENABLED
+    struct Ring
+    {
+        Solo3v3TraceRecord Records[SOLO_3V3_TRACE_SIZE];
+        uint32 Head = 0;    // next slot to write
+        uint32 Size = 0;
+        uint32 Pass = 0;
+    };
+
+    Ring rings[MAX_BATTLEGROUND_BRACKETS];
+#endif
+};
+
+#define sSoloTrace Solo3v3Trace::instance()
+
+#ifdef SOLO_3V3_TRACE_ENABLED
+#define SOLO_3V3_TRACE_PASS(bracket) sSoloTrace->BeginPass(bracket)
+#define SOLO_3V3_TRACE(bracket, ...) sSoloTrace->Record(bracket, __VA_ARGS__)
+#else
+#define SOLO_3V3_TRACE_PASS(bracket) ((void)0)
+#define SOLO_3V3_TRACE(bracket, ...) ((void)0)
+#endif
+
+#endif // _SOLO_3V3_TRACE_H_
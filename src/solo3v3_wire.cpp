@@ -0,0 +1,132 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_wire.h"
+
+// Encode/decode round trips of every record type, checked by the compiler on each build.
+
+using namespace Solo3v3Wire;
+
+static_assert(SOLO_WIRE_MAX_SIZE <= 0xFFFF, "record size must fit the 16 bit size field");
+
+constexpr bool CheckByteOrder()
+{
+    uint8 buffer[4] = { };
+    PutU32(buffer, 0x11223344);
+    return buffer[0] == 0x44 && buffer[1] == 0x33 && buffer[2] == 0x22 && buffer[3] == 0x11 && GetU32(buffer) == 0x11223344;
+}
+static_assert(CheckByteOrder(), "wire format is little-endian");
+
+constexpr bool CheckHelloRoundTrip()
+{
+    uint8 buffer[SOLO_WIRE_HELLO_SIZE] = { };
+    EncodeHello(buffer, 7);
+
+    RecordView view(buffer, sizeof(buffer));
+    return view.IsComplete() && view.IsWellFormed() && view.Type() == SOLO_WIRE_HELLO && view.Size() == SOLO_WIRE_HELLO_SIZE && view.RealmId() == 7;
+}
+static_assert(CheckHelloRoundTrip(), "HELLO round trip");
+
+constexpr bool CheckJoinRoundTrip()
+{
+    uint8 buffer[SOLO_WIRE_JOIN_SIZE] = { };
+    EncodeJoin(buffer, 2, 0xDEADBEEF, 2215, 15, 2, 1);
+
+    RecordView view(buffer, sizeof(buffer));
+    return view.IsComplete() && view.IsWellFormed() && view.Type() == SOLO_WIRE_JOIN && view.RealmId() == 2 && view.Guid() == 0xDEADBEEF
+        && view.MMR() == 2215 && view.JoinBracket() == 15 && view.JoinRole() == 2 && view.JoinGroupSize() == 1;
+}
+static_assert(CheckJoinRoundTrip(), "JOIN round trip");
+
+constexpr bool CheckLeaveRoundTrip()
+{
+    uint8 buffer[SOLO_WIRE_LEAVE_SIZE] = { };
+    EncodeLeave(buffer, 3, 123456, 9);
+
+    RecordView view(buffer, sizeof(buffer));
+    return view.IsComplete() && view.IsWellFormed() && view.Type() == SOLO_WIRE_LEAVE && view.Guid() == 123456 && view.LeaveBracket() == 9;
+}
+static_assert(CheckLeaveRoundTrip(), "LEAVE round trip");
+
+constexpr bool CheckRatingRoundTrip()
+{
+    uint8 buffer[SOLO_WIRE_RATING_SIZE] = { };
+    EncodeRating(buffer, 3, 42, 1850);
+
+    RecordView view(buffer, sizeof(buffer));
+    return view.IsComplete() && view.IsWellFormed() && view.Type() == SOLO_WIRE_RATING && view.Guid() == 42 && view.MMR() == 1850;
+}
+static_assert(CheckRatingRoundTrip(), "RATING round trip");
+
+constexpr bool CheckProposalRoundTrip()
+{
+    uint32 guids[SOLO_WIRE_MATCH_SIZE] = { 1, 2, 3, 0x80000000, 0xFFFFFFFF, 6 };
+    uint8 buffer[SOLO_WIRE_PROPOSAL_SIZE] = { };
+    EncodeProposal(buffer, 1, 4, guids);
+
+    RecordView view(buffer, sizeof(buffer));
+    if (!view.IsComplete() || !view.IsWellFormed() || view.Type() != SOLO_WIRE_PROPOSAL || view.ProposalBracket() != 4)
+        return false;
+
+    for (uint32 i = 0; i < SOLO_WIRE_MATCH_SIZE; i++)
+        if (view.ProposalGuid(i) != guids[i])
+            return false;
+
+    return true;
+}
+static_assert(CheckProposalRoundTrip(), "PROPOSAL round trip");
+
+constexpr bool CheckResultRoundTrip()
+{
+    uint32 guids[SOLO_WIRE_MATCH_SIZE] = { 10, 20, 30, 40, 50, 60 };
+    uint8 buffer[SOLO_WIRE_RESULT_SIZE] = { };
+    EncodeResult(buffer, 1, 0x01020304, 14, 1, guids);
+
+    RecordView view(buffer, sizeof(buffer));
+    if (!view.IsComplete() || !view.IsWellFormed() || view.Type() != SOLO_WIRE_RESULT || view.ResultInstance() != 0x01020304
+        || view.ResultBracket() != 14 || view.ResultWinner() != 1)
+        return false;
+
+    for (uint32 i = 0; i < SOLO_WIRE_MATCH_SIZE; i++)
+        if (view.ResultGuid(i) != guids[i])
+            return false;
+
+    return true;
+}
+static_assert(CheckResultRoundTrip(), "RESULT round trip");
+
+constexpr bool CheckPartialAndForeignRecords()
+{
+    uint8 buffer[SOLO_WIRE_JOIN_SIZE] = { };
+    EncodeJoin(buffer, 1, 1, 1, 1, 1, 1);
+
+    // half received
+    RecordView partial(buffer, SOLO_WIRE_JOIN_SIZE - 1);
+    if (partial.IsComplete())
+        return false;
+
+    // newer format version
+    buffer[2] = SOLO_WIRE_VERSION + 1;
+    if (RecordView(buffer, sizeof(buffer)).IsWellFormed())
+        return false;
+
+    // known type with the wrong size
+    buffer[2] = SOLO_WIRE_VERSION;
+    buffer[0] = uint8(SOLO_WIRE_JOIN_SIZE + 4);
+    return !RecordView(buffer, sizeof(buffer)).IsWellFormed();
+}
+static_assert(CheckPartialAndForeignRecords(), "partial, foreign version and mis-sized records are detected");
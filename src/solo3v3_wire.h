@@ -0,0 +1,185 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_WIRE_H_
+#define _SOLO_3V3_WIRE_H_
+
+#include "Define.h"
+#include <cstddef>
+
+/*
+ * Matcher event records, shared between the world thread and any matcher running outside of it.
+ *
+ * Fixed layout, little-endian, no padding rules of the compiler involved: every field sits at a
+ * fixed byte offset and is read with shifts, so a record can be read in place from a socket or
+ * ring buffer on any host without parsing or copying.
+ *
+ *  offset  size  field
+ *       0     2  record size in bytes, header included
+ *       2     1  format version (SOLO_WIRE_VERSION)
+ *       3     1  record type (Solo3v3WireType)
+ *       4     4  realm id
+ *       8     -  payload, see the *_SIZE constants and the views below
+ *
+ * A reader must skip records with an unknown type and drop the stream on an unknown version.
+ */
+
+constexpr uint8 SOLO_WIRE_VERSION = 1;
+constexpr uint32 SOLO_WIRE_MATCH_SIZE = 6;      // players per match, [0..2] alliance side, [3..5] horde side
+
+enum Solo3v3WireType : uint8
+{
+    SOLO_WIRE_HELLO     = 1,    // worldserver -> matcher, first record of a connection
+    SOLO_WIRE_JOIN      = 2,    // worldserver -> matcher
+    SOLO_WIRE_LEAVE     = 3,    // worldserver -> matcher
+    SOLO_WIRE_RATING    = 4,    // worldserver -> matcher
+    SOLO_WIRE_PROPOSAL  = 5,    // matcher -> worldserver
+    SOLO_WIRE_RESULT    = 6,    // worldserver -> matcher, a solo arena ended
+};
+
+constexpr size_t SOLO_WIRE_HEADER_SIZE   = 8;
+constexpr size_t SOLO_WIRE_HELLO_SIZE    = SOLO_WIRE_HEADER_SIZE;
+constexpr size_t SOLO_WIRE_JOIN_SIZE     = SOLO_WIRE_HEADER_SIZE + 12;                          // guid, mmr, bracket, role, group size, reserved
+constexpr size_t SOLO_WIRE_LEAVE_SIZE    = SOLO_WIRE_HEADER_SIZE + 8;                           // guid, bracket, 3 reserved
+constexpr size_t SOLO_WIRE_RATING_SIZE   = SOLO_WIRE_HEADER_SIZE + 8;                           // guid, mmr
+constexpr size_t SOLO_WIRE_PROPOSAL_SIZE = SOLO_WIRE_HEADER_SIZE + 4 + 4 * SOLO_WIRE_MATCH_SIZE; // bracket, 3 reserved, guids
+constexpr size_t SOLO_WIRE_RESULT_SIZE   = SOLO_WIRE_HEADER_SIZE + 8 + 4 * SOLO_WIRE_MATCH_SIZE; // instance, bracket, winner, 2 reserved, guids
+constexpr size_t SOLO_WIRE_MAX_SIZE      = SOLO_WIRE_RESULT_SIZE;
+
+namespace Solo3v3Wire
+{
+    constexpr void PutU8(uint8* p, uint8 value) { p[0] = value; }
+    constexpr void PutU16(uint8* p, uint16 value) { p[0] = uint8(value); p[1] = uint8(value >> 8); }
+    constexpr void PutU32(uint8* p, uint32 value) { PutU16(p, uint16(value)); PutU16(p + 2, uint16(value >> 16)); }
+
+    constexpr uint8 GetU8(uint8 const* p) { return p[0]; }
+    constexpr uint16 GetU16(uint8 const* p) { return uint16(p[0] | (p[1] << 8)); }
+    constexpr uint32 GetU32(uint8 const* p) { return uint32(GetU16(p)) | (uint32(GetU16(p + 2)) << 16); }
+
+    constexpr size_t SizeOf(uint8 type)
+    {
+        switch (type)
+        {
+            case SOLO_WIRE_HELLO:       return SOLO_WIRE_HELLO_SIZE;
+            case SOLO_WIRE_JOIN:        return SOLO_WIRE_JOIN_SIZE;
+            case SOLO_WIRE_LEAVE:       return SOLO_WIRE_LEAVE_SIZE;
+            case SOLO_WIRE_RATING:      return SOLO_WIRE_RATING_SIZE;
+            case SOLO_WIRE_PROPOSAL:    return SOLO_WIRE_PROPOSAL_SIZE;
+            case SOLO_WIRE_RESULT:      return SOLO_WIRE_RESULT_SIZE;
+            default:                    return 0;
+        }
+    }
+
+    // Writes the header and zeroes the payload, out must hold SizeOf(type) bytes
+    constexpr void EncodeHeader(uint8* out, Solo3v3WireType type, uint32 realmId)
+    {
+        size_t size = SizeOf(type);
+        for (size_t i = 0; i < size; i++)
+            out[i] = 0;
+
+        PutU16(out, uint16(size));
+        PutU8(out + 2, SOLO_WIRE_VERSION);
+        PutU8(out + 3, type);
+        PutU32(out + 4, realmId);
+    }
+
+    constexpr void EncodeHello(uint8* out, uint32 realmId)
+    {
+        EncodeHeader(out, SOLO_WIRE_HELLO, realmId);
+    }
+
+    constexpr void EncodeJoin(uint8* out, uint32 realmId, uint32 guid, uint32 mmr, uint8 bracket, uint8 role, uint8 groupSize)
+    {
+        EncodeHeader(out, SOLO_WIRE_JOIN, realmId);
+        PutU32(out + 8, guid);
+        PutU32(out + 12, mmr);
+        PutU8(out + 16, bracket);
+        PutU8(out + 17, role);
+        PutU8(out + 18, groupSize);
+    }
+
+    constexpr void EncodeLeave(uint8* out, uint32 realmId, uint32 guid, uint8 bracket)
+    {
+        EncodeHeader(out, SOLO_WIRE_LEAVE, realmId);
+        PutU32(out + 8, guid);
+        PutU8(out + 12, bracket);
+    }
+
+    constexpr void EncodeRating(uint8* out, uint32 realmId, uint32 guid, uint32 mmr)
+    {
+        EncodeHeader(out, SOLO_WIRE_RATING, realmId);
+        PutU32(out + 8, guid);
+        PutU32(out + 12, mmr);
+    }
+
+    constexpr void EncodeProposal(uint8* out, uint32 realmId, uint8 bracket, uint32 const guids[])
+    {
+        EncodeHeader(out, SOLO_WIRE_PROPOSAL, realmId);
+        PutU8(out + 8, bracket);
+        for (uint32 i = 0; i < SOLO_WIRE_MATCH_SIZE; i++)
+            PutU32(out + 12 + 4 * i, guids[i]);
+    }
+
+    constexpr void EncodeResult(uint8* out, uint32 realmId, uint32 instanceId, uint8 bracket, uint8 winner, uint32 const guids[])
+    {
+        EncodeHeader(out, SOLO_WIRE_RESULT, realmId);
+        PutU32(out + 8, instanceId);
+        PutU8(out + 12, bracket);
+        PutU8(out + 13, winner);
+        for (uint32 i = 0; i < SOLO_WIRE_MATCH_SIZE; i++)
+            PutU32(out + 16 + 4 * i, guids[i]);
+    }
+
+    // Read-only view on a record inside a receive buffer. Nothing is copied, every getter reads the bytes in place.
+    class RecordView
+    {
+    public:
+        // available = bytes readable from data on
+        constexpr RecordView(uint8 const* data, size_t available) : _data(data), _available(available) { }
+
+        constexpr bool HasHeader() const { return _available >= SOLO_WIRE_HEADER_SIZE; }
+        constexpr uint16 Size() const { return GetU16(_data); }
+        constexpr uint8 Version() const { return GetU8(_data + 2); }
+        constexpr uint8 Type() const { return GetU8(_data + 3); }
+        constexpr uint32 RealmId() const { return GetU32(_data + 4); }
+
+        // Whole record received
+        constexpr bool IsComplete() const { return HasHeader() && _available >= Size(); }
+        // Known version and the size that belongs to the type. Unknown types are skipped by Size().
+        constexpr bool IsWellFormed() const { return Version() == SOLO_WIRE_VERSION && Size() >= SOLO_WIRE_HEADER_SIZE && (!SizeOf(Type()) || Size() == SizeOf(Type())); }
+
+        // Payload fields, valid for the record type they belong to
+        constexpr uint32 Guid() const { return GetU32(_data + 8); }                                 // JOIN, LEAVE, RATING
+        constexpr uint32 MMR() const { return GetU32(_data + 12); }                                 // JOIN, RATING
+        constexpr uint8 JoinBracket() const { return GetU8(_data + 16); }                           // JOIN
+        constexpr uint8 JoinRole() const { return GetU8(_data + 17); }                              // JOIN
+        constexpr uint8 JoinGroupSize() const { return GetU8(_data + 18); }                         // JOIN
+        constexpr uint8 LeaveBracket() const { return GetU8(_data + 12); }                          // LEAVE
+        constexpr uint8 ProposalBracket() const { return GetU8(_data + 8); }                        // PROPOSAL
+        constexpr uint32 ProposalGuid(uint32 i) const { return GetU32(_data + 12 + 4 * i); }        // PROPOSAL
+        constexpr uint32 ResultInstance() const { return GetU32(_data + 8); }                       // RESULT
+        constexpr uint8 ResultBracket() const { return GetU8(_data + 12); }                         // RESULT
+        constexpr uint8 ResultWinner() const { return GetU8(_data + 13); }                          // RESULT
+        constexpr uint32 ResultGuid(uint32 i) const { return GetU32(_data + 16 + 4 * i); }          // RESULT
+
+    private:
+        uint8 const* _data;
+        size_t _available;
+    };
+}
+
+#endif // _SOLO_3V3_WIRE_H_
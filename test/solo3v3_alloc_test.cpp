@@ -0,0 +1,194 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Allocation count test for the steady state of the solo matcher (src/solo3v3_pack.*).
+ *
+ * Replaces the global operator new of the test binary with one that counts calls while a
+ * Solo3v3AllocScope is open on the thread. A queue update that finds the pack buffers already
+ * grown must not allocate: collecting, sorting, packing and checking the selection all reuse
+ * them. Everything around it (players, queues, temp teams) needs the core and is not covered.
+ *
+ * Not part of the module build, it only needs Define.h of the core:
+ *   clang++ -std=c++17 -g -O1 -I src -I <azerothcore>/src/common \
+ *       test/solo3v3_alloc_test.cpp src/solo3v3_pack.cpp -o solo3v3_alloc_test && ./solo3v3_alloc_test
+ */
+
+#include "solo3v3_pack.h"
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// GCC matches the inlined std::free against the operator new call and does not see that both are replaced here
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+namespace
+{
+    thread_local bool counting = false;
+    thread_local uint32 allocations = 0;
+
+    void* CountedAlloc(std::size_t size) noexcept
+    {
+        if (counting)
+            allocations++;
+
+        return std::malloc(size ? size : 1);
+    }
+
+    void CountedFree(void* p) noexcept
+    {
+        std::free(p);
+    }
+
+    // Counts the allocations of the current thread while it lives
+    class Solo3v3AllocScope
+    {
+    public:
+        Solo3v3AllocScope() { allocations = 0; counting = true; }
+        ~Solo3v3AllocScope() { counting = false; }
+
+        uint32 Count() const { return allocations; }
+    };
+}
+
+void* operator new(std::size_t size)
+{
+    if (void* p = CountedAlloc(size))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept { return CountedAlloc(size); }
+void* operator new[](std::size_t size, std::nothrow_t const&) noexcept { return CountedAlloc(size); }
+void operator delete(void* p) noexcept { CountedFree(p); }
+void operator delete[](void* p) noexcept { CountedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { CountedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { CountedFree(p); }
+
+namespace
+{
+    constexpr uint32 TEST_GROUPS = 64;
+
+    uint32 failures = 0;
+
+    void Expect(bool cond, char const* what)
+    {
+        if (cond)
+            return;
+
+        std::fprintf(stderr, "solo3v3_alloc_test: %s\n", what);
+        failures++;
+    }
+
+    // The queue of one bracket: every third group a duo, roles and MMR spread, some equal waits
+    void CollectGroups(std::vector<Solo3v3PackGroup>& groups, uint32 tick)
+    {
+        groups.clear();
+
+        for (uint32 i = 0; i < TEST_GROUPS; i++)
+        {
+            Solo3v3PackGroup group;
+            group.MMR = 1500 + (i * 37 + tick) % 400;
+            group.Waited = ((i * 7) % 16) * 1000 + tick;
+            group.Size = i % 3 == 2 ? 2 : 1;
+            group.Roles[0] = uint8((i / 2) % SOLO_PACK_ROLES);
+            group.Roles[1] = uint8((i / 2 + 1) % SOLO_PACK_ROLES);
+            group.Index = i;
+            groups.push_back(group);
+        }
+    }
+
+    // Like Solo3v3::CheckSolo3v3Arena: collect, sort, pack, then check what was picked
+    bool QueueUpdate(std::vector<Solo3v3PackGroup>& groups, Solo3v3PackOptions const& options, uint32 tick)
+    {
+        CollectGroups(groups, tick);
+        Solo3v3SortOldestFirst(groups);
+
+        bool matched = Solo3v3FindMatch(groups, options, [](Solo3v3PackGroup const& anchor)
+        {
+            return 100 + anchor.Waited / 100;
+        });
+
+        if (!matched)
+            return false;
+
+        Solo3v3SelectedGroup selected[SOLO_PACK_MATCH_SIZE];
+        uint32 count = 0;
+
+        for (Solo3v3PackGroup const& group : groups)
+        {
+            if (group.Result != SOLO_PACK_SELECTED || count >= SOLO_PACK_MATCH_SIZE)
+                continue;
+
+            Solo3v3SelectedGroup& entry = selected[count++];
+            entry.Key = group.Index;
+            entry.Side = group.Side;
+            entry.ListSide = group.Side;
+            entry.Size = group.Size;
+
+            for (uint8 p = 0; p < group.Size; p++)
+            {
+                entry.Players[p] = uint64(group.Index) * 2 + p;
+                entry.Roles[p] = group.Roles[p];
+                entry.Queued[p] = true;
+            }
+        }
+
+        return Solo3v3CheckSelection(selected, count, options.FilterTalents).Error == SOLO_SELECTION_OK;
+    }
+}
+
+int main()
+{
+    {
+        Solo3v3AllocScope scope;
+        std::vector<uint32> probe(4);
+        Expect(scope.Count() == 1, "the allocation hook does not count");
+    }
+
+    Solo3v3PackOptions variants[4];
+    variants[1].AllowDuos = true;
+    variants[2].UseWindow = true;
+    variants[2].MaxAnchors = 4;
+    variants[3].AllowDuos = true;
+    variants[3].UseWindow = true;
+    variants[3].MaxAnchors = 16;
+
+    std::vector<Solo3v3PackGroup> groups;
+
+    for (Solo3v3PackOptions const& options : variants)
+    {
+        // The first update grows the buffer, like the first queue update after startup
+        Expect(QueueUpdate(groups, options, 0), "no match formed in a full queue");
+
+        Solo3v3AllocScope scope;
+        for (uint32 tick = 1; tick <= 100; tick++)
+            QueueUpdate(groups, options, tick);
+
+        Expect(scope.Count() == 0, "a steady state queue update allocated");
+    }
+
+    if (failures)
+        return EXIT_FAILURE;
+
+    std::printf("solo3v3_alloc_test: ok\n");
+    return EXIT_SUCCESS;
+}